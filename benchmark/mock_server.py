@@ -0,0 +1,780 @@
+#!/usr/bin/env python3
+"""Local mock of an HTTP file server and a (path-style) S3-compatible object store, for offline benchmarks.
+
+Objects live in memory and are addressed as /<bucket>/<key>, both over plain HTTP and through the S3 API. Supported:
+HEAD/GET (including single and multi-range requests), PUT, DELETE, ListObjectsV2 and multipart uploads. Signatures are
+not checked. A plain POST to /<bucket>/<key> stores the body like a PUT, but answers with 201 Created. Full (non-range)
+GETs are gzip-compressed if the client accepts it, unless the object is stored with a Content-Encoding.
+
+Objects that are uploaded with an additional checksum (CRC32C or CRC64NVME) remember its algorithm, and full GETs with
+`x-amz-checksum-mode: ENABLED` return the checksum of the object as it is stored.
+
+The HuggingFace hub API is emulated on top of the objects in bucket `hf` (set `hf_endpoint` to the server's url): the
+file `path` of repository `hf://<type>/<owner>/<name>` is the object /hf/<type>/<owner>/<name>/<path>. Supported are
+tree listings (/api/<type>/<owner>/<name>/tree/<revision>/<path>, paginated with `limit` and `cursor`) and reads through
+/<type>/<owner>/<name>/resolve/<revision>/<path>, which redirect to the object. Like the hub does to its CDN, the
+redirect goes to another host: from 127.0.0.1 to localhost and vice versa.
+
+Faults can be injected to emulate a remote store: a fixed latency (plus jitter) before the first byte of every
+response, a per-connection bandwidth limit and a rate of requests that fail with a 503.
+
+Fault rules target the requests whose path (including the query string) starts with a prefix, optionally only those
+with a given method. They are registered with a GET request, so that tests can register them through DuckDB itself
+(e.g. with read_text), and take the following query parameters:
+    path            prefix of the requests the rule applies to (required)
+    method          only apply the rule to requests with this method
+    count           only apply the rule to the first `count` matching requests (default: all of them)
+    status          respond with this status instead of handling the request
+    retry_after     send a Retry-After header with the status, and answer 429 to every matching request until it passed
+    latency_ms      delay before the response
+    max_in_flight   answer 429 to requests beyond this many concurrent matching requests
+    truncate        close the connection after this many bytes of the response body
+    redirect        respond with a 302 to this location
+    ignore_range    respond to range requests with the whole object
+
+Control endpoints (never delayed or failed):
+    GET  /__stats    request statistics since the last reset, as JSON
+    POST /__reset    resets the statistics and removes all fault rules
+    POST /__config   updates the fault injection at runtime, e.g. {"latency_ms": 20, "error_rate": 0.01}
+    GET  /__fault    adds a fault rule, see above; HEAD requests are answered without adding it
+    GET  /__encode   stores the object `path` gzip-compressed with Content-Encoding gzip, as if it had been uploaded
+                     that way; HEAD requests are answered without changing it
+"""
+
+import argparse
+import base64
+import bisect
+import email.utils
+import gzip
+import hashlib
+import json
+import random
+import re
+import sys
+import threading
+import time
+import urllib.parse
+import uuid
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from xml.sax.saxutils import escape
+
+S3_NS = "http://s3.amazonaws.com/doc/2006-03-01/"
+HF_BUCKET = "hf"
+HF_TREE = re.compile(r"/api/(datasets|spaces)/([^/]+/[^/]+)/tree/([^/]+)(/.*)?")
+HF_RESOLVE = re.compile(r"/(datasets|spaces)/([^/]+/[^/]+)/resolve/([^/]+)/(.+)")
+CHUNK_SIZE = 64 * 1024
+
+
+def crc_table(polynomial):
+    table = []
+    for byte in range(256):
+        crc = byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ polynomial if crc & 1 else crc >> 1
+        table.append(crc)
+    return table
+
+
+# reflected polynomials, with the width of the CRC in bytes
+CHECKSUMS = {
+    "CRC32C": (crc_table(0x82F63B78), 4),
+    "CRC64NVME": (crc_table(0x9A6C9329AC4BC9B5), 8),
+}
+
+
+def checksum(algorithm, data):
+    """S3 additional checksum of `data`: the CRC in big-endian byte order, base64 encoded"""
+    table, width = CHECKSUMS[algorithm]
+    mask = (1 << (8 * width)) - 1
+    crc = mask
+    for byte in data:
+        crc = table[(crc ^ byte) & 0xFF] ^ (crc >> 8)
+    return base64.b64encode((crc ^ mask).to_bytes(width, "big")).decode()
+
+
+def object_metadata(headers):
+    """Metadata of an object that is stored with the object: its Content-Encoding and checksum algorithm"""
+    metadata = {}
+    if headers.get("Content-Encoding"):
+        metadata["encoding"] = headers["Content-Encoding"]
+    algorithm = headers.get("x-amz-checksum-algorithm", "").upper()
+    for name in CHECKSUMS:
+        if headers.get("x-amz-checksum-" + name.lower()):
+            algorithm = name
+    if algorithm in CHECKSUMS:
+        metadata["checksum_algorithm"] = algorithm
+    return metadata
+
+
+class ObjectStore:
+    def __init__(self):
+        self.lock = threading.Lock()
+        # bucket -> key -> (data, etag, last_modified, metadata)
+        self.objects = {}
+        # bucket -> sorted list of keys, for listings
+        self.sorted_keys = {}
+        # upload id -> (bucket, key, {part number: data}, metadata)
+        self.uploads = {}
+
+    def put(self, bucket, key, data, etag=None, metadata=None):
+        etag = etag or '"%s"' % hashlib.md5(data).hexdigest()
+        with self.lock:
+            objects = self.objects.setdefault(bucket, {})
+            keys = self.sorted_keys.setdefault(bucket, [])
+            if key not in objects:
+                bisect.insort(keys, key)
+            objects[key] = (data, etag, time.time(), metadata or {})
+        return etag
+
+    def put_many(self, bucket, keys, data):
+        """Bulk insert of objects with identical contents, used for large synthetic listings"""
+        etag = '"%s"' % hashlib.md5(data).hexdigest()
+        now = time.time()
+        with self.lock:
+            objects = self.objects.setdefault(bucket, {})
+            for key in keys:
+                objects[key] = (data, etag, now, {})
+            self.sorted_keys[bucket] = sorted(objects.keys())
+
+    def get(self, bucket, key):
+        with self.lock:
+            return self.objects.get(bucket, {}).get(key)
+
+    def delete(self, bucket, key):
+        with self.lock:
+            objects = self.objects.get(bucket, {})
+            if key in objects:
+                del objects[key]
+                keys = self.sorted_keys[bucket]
+                keys.pop(bisect.bisect_left(keys, key))
+
+    def list(self, bucket, prefix, delimiter, start_after, max_keys):
+        """Returns (contents, common prefixes, next start key or None)"""
+        with self.lock:
+            objects = self.objects.get(bucket, {})
+            keys = self.sorted_keys.get(bucket, [])
+            idx = bisect.bisect_left(keys, prefix)
+            if start_after:
+                idx = max(idx, bisect.bisect_right(keys, start_after))
+            contents = []
+            prefixes = []
+            last = None
+            while idx < len(keys) and len(contents) + len(prefixes) < max_keys:
+                key = keys[idx]
+                if not key.startswith(prefix):
+                    break
+                if delimiter:
+                    pos = key.find(delimiter, len(prefix))
+                    if pos >= 0:
+                        common = key[: pos + len(delimiter)]
+                        prefixes.append(common)
+                        # skip all keys with this common prefix
+                        idx = bisect.bisect_left(keys, common + "\uffff")
+                        last = keys[idx - 1]
+                        continue
+                data, etag, modified, metadata = objects[key]
+                contents.append((key, len(data), etag, modified))
+                last = key
+                idx += 1
+            truncated = idx < len(keys) and keys[idx].startswith(prefix)
+            return contents, prefixes, last if truncated else None
+
+    def create_upload(self, bucket, key, metadata):
+        upload_id = uuid.uuid4().hex
+        with self.lock:
+            self.uploads[upload_id] = (bucket, key, {}, metadata)
+        return upload_id
+
+    def put_part(self, upload_id, part_number, data):
+        with self.lock:
+            if upload_id not in self.uploads:
+                return None
+            self.uploads[upload_id][2][part_number] = data
+        return '"%s"' % hashlib.md5(data).hexdigest()
+
+    def complete_upload(self, upload_id, part_numbers):
+        with self.lock:
+            upload = self.uploads.pop(upload_id, None)
+        if upload is None:
+            return None
+        bucket, key, parts, metadata = upload
+        if any(number not in parts for number in part_numbers):
+            return None
+        data = b"".join(parts[number] for number in part_numbers)
+        digest = hashlib.md5(b"".join(hashlib.md5(parts[n]).digest() for n in part_numbers)).hexdigest()
+        return self.put(bucket, key, data, '"%s-%d"' % (digest, len(part_numbers)), metadata)
+
+    def encode(self, bucket, key):
+        """Stores an object gzip-compressed with Content-Encoding gzip, returns False if it does not exist"""
+        entry = self.get(bucket, key)
+        if entry is None:
+            return False
+        data, etag, modified, metadata = entry
+        self.put(bucket, key, gzip.compress(data), metadata=dict(metadata, encoding="gzip"))
+        return True
+
+    def abort_upload(self, upload_id):
+        with self.lock:
+            self.uploads.pop(upload_id, None)
+
+
+class Stats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.reset()
+
+    def reset(self):
+        with self.lock:
+            self.started = time.time()
+            self.requests = 0
+            self.by_method = {}
+            self.by_status = {}
+            self.bytes_sent = 0
+            self.bytes_received = 0
+            self.latencies = []
+
+    def record(self, method, status, sent, received, latency):
+        with self.lock:
+            self.requests += 1
+            self.by_method[method] = self.by_method.get(method, 0) + 1
+            self.by_status[str(status)] = self.by_status.get(str(status), 0) + 1
+            self.bytes_sent += sent
+            self.bytes_received += received
+            self.latencies.append(latency)
+
+    def snapshot(self):
+        with self.lock:
+            latencies = sorted(self.latencies)
+
+            def percentile(p):
+                if not latencies:
+                    return 0.0
+                return latencies[min(len(latencies) - 1, int(p * len(latencies)))] * 1000
+
+            return {
+                "elapsed_s": time.time() - self.started,
+                "requests": self.requests,
+                "by_method": dict(self.by_method),
+                "by_status": dict(self.by_status),
+                "bytes_sent": self.bytes_sent,
+                "bytes_received": self.bytes_received,
+                "latency_p50_ms": percentile(0.50),
+                "latency_p99_ms": percentile(0.99),
+                "latency_max_ms": latencies[-1] * 1000 if latencies else 0.0,
+            }
+
+
+class Faults:
+    def __init__(self, latency_ms=0.0, jitter_ms=0.0, bandwidth_mbps=0.0, error_rate=0.0):
+        self.latency_ms = latency_ms
+        self.jitter_ms = jitter_ms
+        self.bandwidth_mbps = bandwidth_mbps
+        self.error_rate = error_rate
+
+    def update(self, config):
+        for name in ("latency_ms", "jitter_ms", "bandwidth_mbps", "error_rate"):
+            if name in config:
+                setattr(self, name, float(config[name]))
+
+    def as_dict(self):
+        return dict(self.__dict__)
+
+
+class FaultRule:
+    def __init__(self, query):
+        self.lock = threading.Lock()
+        self.path = query["path"]
+        self.method = query.get("method", "").upper()
+        self.count = int(query.get("count", 0))
+        self.unlimited = self.count == 0
+        self.status = int(query.get("status", 0))
+        self.retry_after = int(query.get("retry_after", 0))
+        self.latency_ms = float(query.get("latency_ms", 0))
+        self.max_in_flight = int(query.get("max_in_flight", 0))
+        self.truncate = int(query["truncate"]) if "truncate" in query else None
+        self.redirect = query.get("redirect")
+        self.ignore_range = query.get("ignore_range", "") not in ("", "0", "false")
+        self.in_flight = 0
+        self.paused_until = 0.0
+
+    def matches(self, method, path):
+        return path.startswith(self.path) and (not self.method or self.method == method)
+
+    def enter(self):
+        """Returns (throttled, applies): whether the request is refused with a 429, and whether the rule applies"""
+        with self.lock:
+            if time.time() < self.paused_until:
+                return True, False
+            if self.max_in_flight:
+                if self.in_flight >= self.max_in_flight:
+                    return True, False
+                self.in_flight += 1
+            if self.unlimited:
+                return False, True
+            if self.count == 0:
+                return False, False
+            self.count -= 1
+            return False, True
+
+    def leave(self):
+        if self.max_in_flight:
+            with self.lock:
+                self.in_flight -= 1
+
+    def pause(self):
+        with self.lock:
+            self.paused_until = max(self.paused_until, time.time() + self.retry_after)
+
+
+class FaultRules:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.rules = []
+
+    def add(self, rule):
+        with self.lock:
+            self.rules.append(rule)
+
+    def clear(self):
+        with self.lock:
+            self.rules = []
+
+    def match(self, method, path):
+        with self.lock:
+            return [rule for rule in self.rules if rule.matches(method, path)]
+
+
+def parse_ranges(header, size):
+    """Parses a Range header into a list of inclusive (start, end) pairs, None if it is not satisfiable"""
+    match = re.fullmatch(r"\s*bytes\s*=\s*(.+)", header)
+    if not match:
+        return None
+    ranges = []
+    for spec in match.group(1).split(","):
+        start, _, end = spec.strip().partition("-")
+        if start == "":
+            if not end:
+                return None
+            length = int(end)
+            if length == 0:
+                continue
+            ranges.append((max(0, size - length), size - 1))
+            continue
+        start = int(start)
+        end = int(end) if end else size - 1
+        if start >= size or end < start:
+            continue
+        ranges.append((start, min(end, size - 1)))
+    return ranges or None
+
+
+class MockHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    server_version = "httpfs-mock/1.0"
+
+    def log_message(self, format, *args):
+        if self.server.verbose:
+            super().log_message(format, *args)
+
+    # --- plumbing ---
+
+    def setup_request(self):
+        """Parses the request line into bucket, key and query parameters"""
+        url = urllib.parse.urlsplit(self.path)
+        self.query = urllib.parse.parse_qs(url.query, keep_blank_values=True)
+        path = urllib.parse.unquote(url.path).lstrip("/")
+        self.bucket, _, self.key = path.partition("/")
+        self.start_time = time.time()
+        self.sent = 0
+        self.received = 0
+        self.status = 0
+        self.truncate = None
+        self.ignore_range = False
+
+    def read_body(self):
+        if self.headers.get("Transfer-Encoding", "").lower() == "chunked":
+            chunks = []
+            while True:
+                line = self.rfile.readline().split(b";")[0].strip()
+                length = int(line, 16)
+                if length == 0:
+                    # trailers
+                    while self.rfile.readline().strip():
+                        pass
+                    break
+                chunks.append(self.rfile.read(length))
+                self.rfile.readline()
+            body = b"".join(chunks)
+        else:
+            body = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+        self.received += len(body)
+        return body
+
+    def begin(self, status, headers, length):
+        self.status = status
+        self.send_response(status)
+        for name, value in headers.items():
+            self.send_header(name, value)
+        self.send_header("Content-Length", str(length))
+        self.end_headers()
+
+    def write_body(self, body):
+        if self.truncate is not None and self.truncate < len(body):
+            # the client was promised the whole body, it sees a connection that breaks off in the middle of it
+            body = body[: self.truncate]
+            self.close_connection = True
+        bandwidth = self.server.faults.bandwidth_mbps * 1024 * 1024
+        start = time.time()
+        for offset in range(0, len(body), CHUNK_SIZE):
+            chunk = body[offset : offset + CHUNK_SIZE]
+            self.wfile.write(chunk)
+            self.sent += len(chunk)
+            if bandwidth > 0:
+                ahead = self.sent / bandwidth - (time.time() - start)
+                if ahead > 0:
+                    time.sleep(ahead)
+
+    def respond(self, status, body=b"", headers=None):
+        headers = dict(headers or {})
+        if isinstance(body, str):
+            body = body.encode()
+        self.begin(status, headers, len(body))
+        if self.method != "HEAD":
+            self.write_body(body)
+
+    def respond_xml(self, status, xml):
+        self.respond(status, '<?xml version="1.0" encoding="UTF-8"?>\n' + xml, {"Content-Type": "application/xml"})
+
+    def respond_error(self, status, code, message):
+        self.respond_xml(status, "<Error><Code>%s</Code><Message>%s</Message></Error>" % (code, escape(message)))
+
+    def dispatch(self, method):
+        self.setup_request()
+        self.method = method
+        if self.bucket.startswith("__"):
+            return self.control(method)
+        try:
+            # Requests must be read entirely before responding, otherwise the connection cannot be reused
+            body = self.read_body() if method in ("PUT", "POST") else b""
+            faults = self.server.faults
+            delay = faults.latency_ms + random.uniform(0, faults.jitter_ms)
+            if delay > 0:
+                time.sleep(delay / 1000)
+            if faults.error_rate > 0 and random.random() < faults.error_rate:
+                return self.respond_error(503, "SlowDown", "Injected failure")
+            entered = []
+            try:
+                for rule in self.server.rules.match(method, self.path):
+                    throttled, applies = rule.enter()
+                    if throttled:
+                        return self.respond_error(429, "SlowDown", "Too many requests")
+                    entered.append(rule)
+                    if applies and self.apply_rule(rule):
+                        return
+            finally:
+                # Leave before responding: once the client sees the response, it may send its next request
+                for rule in entered:
+                    rule.leave()
+            if self.handle_hf(method):
+                return
+            getattr(self, "handle_" + method.lower())(body)
+        finally:
+            self.server.stats.record(
+                method, self.status, self.sent, self.received, time.time() - self.start_time
+            )
+
+    def apply_rule(self, rule):
+        """Applies a fault rule to the request, returns whether the request was answered by it"""
+        if rule.latency_ms > 0:
+            time.sleep(rule.latency_ms / 1000)
+        if rule.truncate is not None:
+            self.truncate = rule.truncate
+        self.ignore_range = self.ignore_range or rule.ignore_range
+        if rule.redirect:
+            self.respond(302, "Found: " + rule.redirect, {"Location": rule.redirect})
+            return True
+        if rule.status:
+            headers = {}
+            if rule.retry_after:
+                headers["Retry-After"] = str(rule.retry_after)
+                rule.pause()
+            self.respond(rule.status, "Injected failure", headers)
+            return True
+        return False
+
+    def control(self, method):
+        if self.bucket == "__stats" and method == "GET":
+            result = self.server.stats.snapshot()
+            result["faults"] = self.server.faults.as_dict()
+            return self.respond(200, json.dumps(result), {"Content-Type": "application/json"})
+        if self.bucket == "__reset" and method == "POST":
+            self.read_body()
+            self.server.stats.reset()
+            self.server.rules.clear()
+            return self.respond(200, "{}", {"Content-Type": "application/json"})
+        if self.bucket == "__config" and method == "POST":
+            body = self.read_body()
+            self.server.faults.update(json.loads(body or b"{}"))
+            return self.respond(200, json.dumps(self.server.faults.as_dict()), {"Content-Type": "application/json"})
+        if self.bucket == "__fault" and method in ("GET", "HEAD"):
+            # the body is the same for both, so that clients that check the size first can read it
+            if method == "GET":
+                self.server.rules.add(FaultRule({name: values[0] for name, values in self.query.items()}))
+            return self.respond(200, "ok\n", {"Content-Type": "text/plain"})
+        if self.bucket == "__encode" and method in ("GET", "HEAD"):
+            bucket, _, key = self.query.get("path", [""])[0].lstrip("/").partition("/")
+            if method == "GET" and not self.server.store.encode(bucket, key):
+                return self.respond(404, "no such object\n", {"Content-Type": "text/plain"})
+            return self.respond(200, "ok\n", {"Content-Type": "text/plain"})
+        return self.respond(404, "unknown control endpoint")
+
+    do_HEAD = lambda self: self.dispatch("HEAD")
+    do_GET = lambda self: self.dispatch("GET")
+    do_PUT = lambda self: self.dispatch("PUT")
+    do_POST = lambda self: self.dispatch("POST")
+    do_DELETE = lambda self: self.dispatch("DELETE")
+
+    # --- HuggingFace hub ---
+
+    def handle_hf(self, method):
+        """Answers requests to the HuggingFace API, returns False for other requests"""
+        if method not in ("GET", "HEAD"):
+            return False
+        path = urllib.parse.unquote(urllib.parse.urlsplit(self.path).path)
+        match = HF_TREE.fullmatch(path)
+        if match:
+            repo_type, repository, revision, dir_path = match.groups()
+            self.hf_tree(repo_type, repository, (dir_path or "").strip("/"))
+            return True
+        match = HF_RESOLVE.fullmatch(path)
+        if match:
+            repo_type, repository, revision, file_path = match.groups()
+            key = "%s/%s/%s" % (repo_type, repository, file_path)
+            if self.server.store.get(HF_BUCKET, key) is None:
+                self.respond(404, json.dumps({"error": "Entry not found"}), {"Content-Type": "application/json"})
+                return True
+            host = self.headers.get("Host", "")
+            if host.startswith("127.0.0.1"):
+                host = "localhost" + host[len("127.0.0.1") :]
+            elif host.startswith("localhost"):
+                host = "127.0.0.1" + host[len("localhost") :]
+            location = "http://%s/%s/%s" % (host, HF_BUCKET, urllib.parse.quote(key))
+            self.respond(302, "Found. Redirecting to " + location, {"Location": location})
+            return True
+        return False
+
+    def hf_tree(self, repo_type, repository, dir_path):
+        query = {name: values[0] for name, values in self.query.items()}
+        recursive = query.get("recursive") == "true"
+        limit = int(query.get("limit", 0)) or 1000
+        repo_prefix = "%s/%s/" % (repo_type, repository)
+        prefix = repo_prefix + (dir_path + "/" if dir_path else "")
+        contents, prefixes, next_key = self.server.store.list(
+            HF_BUCKET, prefix, "" if recursive else "/", query.get("cursor", ""), limit
+        )
+        if not contents and not prefixes and dir_path and "cursor" not in query:
+            return self.respond(404, json.dumps({"error": "Entry not found"}), {"Content-Type": "application/json"})
+        entries = []
+        for common in prefixes:
+            entries.append({"type": "directory", "oid": "0" * 40, "size": 0, "path": common[len(repo_prefix) : -1]})
+        for key, size, etag, modified in contents:
+            entries.append({"type": "file", "oid": etag.strip('"'), "size": size, "path": key[len(repo_prefix) :]})
+        headers = {"Content-Type": "application/json"}
+        if next_key:
+            url = urllib.parse.urlsplit(self.path)
+            query["cursor"] = next_key
+            headers["Link"] = '<http://%s%s?%s>; rel="next"' % (
+                self.headers.get("Host", ""),
+                url.path,
+                urllib.parse.urlencode(query),
+            )
+        self.respond(200, json.dumps(entries), headers)
+
+    # --- object operations ---
+
+    def object_headers(self, entry):
+        data, etag, modified, metadata = entry
+        headers = {
+            "ETag": etag,
+            "Last-Modified": email.utils.formatdate(modified, usegmt=True),
+            "Accept-Ranges": "bytes",
+            "Content-Type": "application/octet-stream",
+        }
+        if "encoding" in metadata:
+            headers["Content-Encoding"] = metadata["encoding"]
+        return headers
+
+    def handle_head(self, body):
+        entry = self.server.store.get(self.bucket, self.key)
+        if entry is None:
+            return self.respond(404)
+        self.begin(200, self.object_headers(entry), len(entry[0]))
+
+    def handle_get(self, body):
+        if self.key == "" and "list-type" in self.query:
+            return self.list_objects()
+        entry = self.server.store.get(self.bucket, self.key)
+        if entry is None:
+            return self.respond_error(404, "NoSuchKey", "The specified key does not exist.")
+        data = entry[0]
+        headers = self.object_headers(entry)
+        range_header = None if self.ignore_range else self.headers.get("Range")
+        if not range_header:
+            metadata = entry[3]
+            algorithm = metadata.get("checksum_algorithm")
+            if algorithm and self.headers.get("x-amz-checksum-mode", "").upper() == "ENABLED":
+                # the checksum of the object as it is stored, not of a body that is compressed in transit
+                headers["x-amz-checksum-" + algorithm.lower()] = checksum(algorithm, data)
+            if "encoding" not in metadata and "gzip" in self.headers.get("Accept-Encoding", ""):
+                headers["Content-Encoding"] = "gzip"
+                data = gzip.compress(data)
+            return self.respond(200, data, headers)
+        ranges = parse_ranges(range_header, len(data))
+        if ranges is None:
+            return self.respond(416, headers={"Content-Range": "bytes */%d" % len(data)})
+        if len(ranges) == 1:
+            start, end = ranges[0]
+            headers["Content-Range"] = "bytes %d-%d/%d" % (start, end, len(data))
+            return self.respond(206, data[start : end + 1], headers)
+        boundary = uuid.uuid4().hex
+        parts = []
+        for start, end in ranges:
+            parts.append(
+                (
+                    "--%s\r\nContent-Type: application/octet-stream\r\nContent-Range: bytes %d-%d/%d\r\n\r\n"
+                    % (boundary, start, end, len(data))
+                ).encode()
+            )
+            parts.append(data[start : end + 1])
+            parts.append(b"\r\n")
+        parts.append(("--%s--\r\n" % boundary).encode())
+        headers["Content-Type"] = "multipart/byteranges; boundary=" + boundary
+        self.respond(206, b"".join(parts), headers)
+
+    def handle_put(self, body):
+        if "uploadId" in self.query:
+            etag = self.server.store.put_part(self.query["uploadId"][0], int(self.query["partNumber"][0]), body)
+            if etag is None:
+                return self.respond_error(404, "NoSuchUpload", "The specified upload does not exist.")
+            return self.respond(200, headers={"ETag": etag})
+        etag = self.server.store.put(self.bucket, self.key, body, metadata=object_metadata(self.headers))
+        self.respond(200, headers={"ETag": etag})
+
+    def handle_post(self, body):
+        store = self.server.store
+        if "uploads" in self.query:
+            upload_id = store.create_upload(self.bucket, self.key, object_metadata(self.headers))
+            return self.respond_xml(
+                200,
+                '<InitiateMultipartUploadResult xmlns="%s"><Bucket>%s</Bucket><Key>%s</Key><UploadId>%s</UploadId>'
+                "</InitiateMultipartUploadResult>" % (S3_NS, escape(self.bucket), escape(self.key), upload_id),
+            )
+        if "uploadId" in self.query:
+            part_numbers = [int(n) for n in re.findall(rb"<PartNumber>(\d+)</PartNumber>", body)]
+            etag = store.complete_upload(self.query["uploadId"][0], part_numbers)
+            if etag is None:
+                return self.respond_error(400, "InvalidPart", "One or more of the specified parts could not be found.")
+            return self.respond_xml(
+                200,
+                '<CompleteMultipartUploadResult xmlns="%s"><Bucket>%s</Bucket><Key>%s</Key><ETag>%s</ETag>'
+                "</CompleteMultipartUploadResult>"
+                % (S3_NS, escape(self.bucket), escape(self.key), escape(etag)),
+            )
+        if self.key:
+            etag = store.put(self.bucket, self.key, body, metadata=object_metadata(self.headers))
+            return self.respond(201, headers={"ETag": etag})
+        self.respond_error(400, "InvalidRequest", "Unsupported POST request")
+
+    def handle_delete(self, body):
+        if "uploadId" in self.query:
+            self.server.store.abort_upload(self.query["uploadId"][0])
+        else:
+            self.server.store.delete(self.bucket, self.key)
+        self.respond(204)
+
+    def list_objects(self):
+        query = {name: values[0] for name, values in self.query.items()}
+        prefix = query.get("prefix", "")
+        delimiter = query.get("delimiter", "")
+        max_keys = min(int(query.get("max-keys", 1000)), 1000)
+        start_after = query.get("continuation-token") or query.get("start-after", "")
+        url_encode = query.get("encoding-type") == "url"
+
+        def encode(key):
+            return urllib.parse.quote(key, safe="/") if url_encode else escape(key)
+
+        contents, prefixes, next_key = self.server.store.list(self.bucket, prefix, delimiter, start_after, max_keys)
+        xml = ['<ListBucketResult xmlns="%s"><Name>%s</Name>' % (S3_NS, escape(self.bucket))]
+        xml.append("<Prefix>%s</Prefix><KeyCount>%d</KeyCount>" % (encode(prefix), len(contents) + len(prefixes)))
+        xml.append("<MaxKeys>%d</MaxKeys><IsTruncated>%s</IsTruncated>" % (max_keys, "true" if next_key else "false"))
+        if next_key:
+            xml.append("<NextContinuationToken>%s</NextContinuationToken>" % escape(next_key))
+        for key, size, etag, modified in contents:
+            xml.append(
+                "<Contents><Key>%s</Key><LastModified>%s</LastModified><ETag>%s</ETag><Size>%d</Size>"
+                "<StorageClass>STANDARD</StorageClass></Contents>"
+                % (
+                    encode(key),
+                    time.strftime("%Y-%m-%dT%H:%M:%S.000Z", time.gmtime(modified)),
+                    escape(etag),
+                    size,
+                )
+            )
+        for common in prefixes:
+            xml.append("<CommonPrefixes><Prefix>%s</Prefix></CommonPrefixes>" % encode(common))
+        xml.append("</ListBucketResult>")
+        self.respond_xml(200, "".join(xml))
+
+
+class MockServer(ThreadingHTTPServer):
+    daemon_threads = True
+    request_queue_size = 256
+
+    def __init__(self, address, faults, verbose=False):
+        super().__init__(address, MockHandler)
+        self.store = ObjectStore()
+        self.stats = Stats()
+        self.faults = faults
+        self.rules = FaultRules()
+        self.verbose = verbose
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=0, help="port to listen on, 0 picks a free port")
+    parser.add_argument("--latency-ms", type=float, default=0, help="delay before the first byte of every response")
+    parser.add_argument("--jitter-ms", type=float, default=0, help="uniformly distributed extra delay")
+    parser.add_argument("--bandwidth-mbps", type=float, default=0, help="per-connection limit in MiB/s, 0 is unlimited")
+    parser.add_argument("--error-rate", type=float, default=0, help="fraction of requests that fail with a 503")
+    parser.add_argument("--seed", type=int, help="seed for latency jitter and error injection")
+    parser.add_argument(
+        "--synthetic-keys",
+        metavar="BUCKET/PREFIX:COUNT",
+        action="append",
+        default=[],
+        help="creates COUNT small objects BUCKET/PREFIX<n>.csv, e.g. for listing benchmarks",
+    )
+    parser.add_argument("--verbose", action="store_true", help="log every request")
+    args = parser.parse_args()
+
+    if args.seed is not None:
+        random.seed(args.seed)
+    faults = Faults(args.latency_ms, args.jitter_ms, args.bandwidth_mbps, args.error_rate)
+    server = MockServer((args.host, args.port), faults, args.verbose)
+    for spec in args.synthetic_keys:
+        path, _, count = spec.rpartition(":")
+        bucket, _, prefix = path.partition("/")
+        server.store.put_many(bucket, ["%s%07d.csv" % (prefix, i) for i in range(int(count))], b"i\n1\n")
+
+    # The benchmark driver reads the port from the first line of output
+    print("listening on %s:%d" % server.server_address[:2], flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,274 @@
+#!/usr/bin/env python3
+"""End-to-end throughput benchmarks of httpfs against the local mock server (benchmark/mock_server.py).
+
+Every scenario runs in a fresh DuckDB CLI process, so no state is shared between scenarios. For each scenario the wall
+time and the statistics of the mock server are reported: requests/s, MiB/s and the server-side p50/p99 latency.
+
+Results can be saved with --output and compared against a saved run with --baseline, which fails if a scenario sends
+more requests or transfers more bytes than allowed by --max-regression. Those do not depend on the speed of the
+machine; wall time differences are reported as well, but never fail the comparison, as they are too noisy on shared CI
+runners.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+import urllib.request
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+
+# Keys created by the mock server for the listing scenario
+LISTING_KEYS = 100000
+# Ranges read by the range read scenarios, spread over the CSV file (of at least 36 bytes per row)
+READ_RANGES = 64
+READ_RANGE_SIZE = 4096
+
+
+def read_ranges_sql(args, mode):
+    step = args.rows * 16 // READ_RANGES
+    offsets = ", ".join(str(i * step) for i in range(READ_RANGES))
+    lengths = ", ".join([str(READ_RANGE_SIZE)] * READ_RANGES)
+    return (
+        "SELECT sum(length(data)) FROM __internal_httpfs_read_ranges('{http}/bench/data.csv', "
+        "[%s], [%s], mode := '%s');" % (offsets, lengths, mode)
+    )
+
+
+class Scenario:
+    def __init__(self, name, description, sql, setup=False):
+        self.name = name
+        self.description = description
+        # Either a string or a function of the benchmark arguments
+        self.sql = sql
+        # Setup scenarios create the data read by later scenarios
+        self.setup = setup
+
+
+SCENARIOS = [
+    Scenario(
+        "multipart_write_csv",
+        "COPY a table to S3 as CSV with a multipart upload",
+        lambda args: "COPY (SELECT range AS id, range * 7 %% 1000 AS val, md5(range::VARCHAR) AS str "
+        "FROM range(%d)) TO 's3://bench/data.csv';" % args.rows,
+        setup=True,
+    ),
+    Scenario(
+        "multipart_write_parquet",
+        "COPY a table to S3 as Parquet with small row groups",
+        lambda args: "COPY (SELECT range AS id, range * 7 %% 1000 AS val, md5(range::VARCHAR) AS str "
+        "FROM range(%d)) TO 's3://bench/data.parquet' (FORMAT parquet, ROW_GROUP_SIZE 16384);" % args.rows,
+        setup=True,
+    ),
+    Scenario(
+        "sequential_csv_scan_http",
+        "Full scan of a CSV file over plain HTTP",
+        "SELECT count(*), sum(val) FROM read_csv('{http}/bench/data.csv');",
+    ),
+    Scenario(
+        "sequential_csv_scan_s3",
+        "Full scan of a CSV file over S3",
+        "SELECT count(*), sum(val) FROM read_csv('s3://bench/data.csv');",
+    ),
+    Scenario(
+        "parquet_column_reads",
+        "Reads of single columns of every row group of a Parquet file",
+        "SELECT sum(val) FROM 's3://bench/data.parquet';",
+    ),
+    Scenario(
+        "parquet_point_lookups",
+        "Selective filters that read few row groups of a Parquet file",
+        lambda args: " ".join(
+            "SELECT str FROM 's3://bench/data.parquet' WHERE id = %d;" % (i * 7919 % args.rows) for i in range(20)
+        ),
+    ),
+    Scenario(
+        "separate_range_reads",
+        "%d ranges of a CSV file, read one at a time" % READ_RANGES,
+        lambda args: read_ranges_sql(args, "read"),
+    ),
+    Scenario(
+        "vectored_range_reads",
+        "The same ranges, read together with ReadV",
+        lambda args: read_ranges_sql(args, "vectored"),
+    ),
+    Scenario(
+        "async_range_reads",
+        "The same ranges, all started with ReadAsync before waiting for them",
+        lambda args: read_ranges_sql(args, "async"),
+    ),
+    Scenario(
+        "glob_listing",
+        "Glob over %d keys" % LISTING_KEYS,
+        "SELECT count(*) FROM glob('s3://listing/keys/*.csv');",
+    ),
+]
+
+
+class MockServer:
+    def __init__(self, args):
+        command = [sys.executable, os.path.join(BENCH_DIR, "mock_server.py"), "--port", "0"]
+        command += ["--synthetic-keys", "listing/keys/k:%d" % LISTING_KEYS]
+        if args.seed is not None:
+            command += ["--seed", str(args.seed)]
+        self.process = subprocess.Popen(command, stdout=subprocess.PIPE, text=True)
+        line = self.process.stdout.readline()
+        if not line.startswith("listening on "):
+            self.process.kill()
+            raise RuntimeError("mock server failed to start")
+        self.address = line.split()[-1]
+        self.url = "http://" + self.address
+
+    def control(self, endpoint, body=None):
+        data = json.dumps(body).encode() if body is not None else None
+        request = urllib.request.Request(self.url + "/" + endpoint, data=data, method="POST" if data else "GET")
+        with urllib.request.urlopen(request) as response:
+            return json.loads(response.read())
+
+    def stop(self):
+        self.process.terminate()
+        self.process.wait()
+
+
+def setup_sql(server):
+    return (
+        "CREATE SECRET bench (TYPE s3, KEY_ID 'bench', SECRET 'bench', REGION 'us-east-1', "
+        "ENDPOINT '%s', URL_STYLE 'path', USE_SSL false);" % server.address
+    )
+
+
+def run_scenario(args, server, scenario):
+    sql = scenario.sql(args) if callable(scenario.sql) else scenario.sql
+    sql = sql.format(http=server.url)
+    server.control("__reset", {})
+    start = time.time()
+    result = subprocess.run(
+        [args.duckdb, "-c", setup_sql(server) + " " + args.settings + " " + sql],
+        capture_output=True,
+        text=True,
+    )
+    wall = time.time() - start
+    stats = server.control("__stats")
+    if result.returncode != 0:
+        raise RuntimeError("scenario %s failed:\n%s%s" % (scenario.name, result.stdout, result.stderr))
+    transferred = stats["bytes_sent"] + stats["bytes_received"]
+    return {
+        "wall_s": wall,
+        "requests": stats["requests"],
+        "by_method": stats["by_method"],
+        "requests_per_s": stats["requests"] / wall,
+        "mib_per_s": transferred / wall / (1024 * 1024),
+        "mib_transferred": transferred / (1024 * 1024),
+        "bytes": transferred,
+        "latency_p50_ms": stats["latency_p50_ms"],
+        "latency_p99_ms": stats["latency_p99_ms"],
+    }
+
+
+def print_results(results):
+    header = "%-26s %8s %9s %9s %9s %9s %9s" % ("scenario", "wall s", "requests", "req/s", "MiB/s", "p50 ms", "p99 ms")
+    print(header)
+    print("-" * len(header))
+    for name, r in results.items():
+        print(
+            "%-26s %8.2f %9d %9.1f %9.1f %9.2f %9.2f"
+            % (name, r["wall_s"], r["requests"], r["requests_per_s"], r["mib_per_s"], r["latency_p50_ms"],
+               r["latency_p99_ms"])
+        )
+
+
+# Metrics that fail the comparison against a baseline, and metrics that are only reported
+GATED_METRICS = ("requests", "bytes")
+REPORTED_METRICS = ("wall_s",)
+
+
+def compare(results, baseline, max_regression):
+    """Returns the lists of (regressions, other changes) of `results` compared to `baseline`"""
+    regressions = []
+    changes = []
+    for name, r in results.items():
+        if name not in baseline:
+            continue
+        b = baseline[name]
+        for metric in GATED_METRICS + REPORTED_METRICS:
+            if metric not in b or metric not in r:
+                # baselines written by older versions of this script lack some metrics
+                continue
+            if b[metric] > 0 and r[metric] > b[metric] * (1 + max_regression):
+                change = "%s: %s went from %s to %s (+%.0f%%)" % (
+                    name,
+                    metric,
+                    b[metric],
+                    r[metric],
+                    (r[metric] / b[metric] - 1) * 100,
+                )
+                (regressions if metric in GATED_METRICS else changes).append(change)
+    return regressions, changes
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--duckdb", default="build/release/duckdb", help="DuckDB CLI with httpfs built in")
+    parser.add_argument("--rows", type=int, default=1000000, help="rows of the generated data files")
+    parser.add_argument("--latency-ms", type=float, default=0, help="injected latency per request")
+    parser.add_argument("--jitter-ms", type=float, default=0, help="injected latency jitter per request")
+    parser.add_argument("--bandwidth-mbps", type=float, default=0, help="per-connection bandwidth limit in MiB/s")
+    parser.add_argument("--error-rate", type=float, default=0, help="fraction of requests that fail with a 503")
+    parser.add_argument("--seed", type=int, default=42, help="seed of the mock server's fault injection")
+    parser.add_argument("--settings", default="", help="SQL run before every scenario, e.g. 'SET threads=4;'")
+    parser.add_argument("--filter", default="", help="only run scenarios whose name contains this string")
+    parser.add_argument("--output", help="write the results to this JSON file")
+    parser.add_argument("--baseline", help="JSON file of an earlier run to compare against")
+    parser.add_argument("--max-regression", type=float, default=0.25, help="allowed relative increase, e.g. 0.25")
+    args = parser.parse_args()
+
+    if not os.path.exists(args.duckdb):
+        print("DuckDB binary %s not found, build it first (make release)" % args.duckdb, file=sys.stderr)
+        return 1
+
+    server = MockServer(args)
+    results = {}
+    try:
+        for scenario in SCENARIOS:
+            selected = args.filter in scenario.name
+            if not selected and not scenario.setup:
+                continue
+            # Faults are only injected into measured scenarios, data is always written
+            faults = {"latency_ms": 0, "jitter_ms": 0, "bandwidth_mbps": 0, "error_rate": 0}
+            if selected:
+                faults = {
+                    "latency_ms": args.latency_ms,
+                    "jitter_ms": args.jitter_ms,
+                    "bandwidth_mbps": args.bandwidth_mbps,
+                    "error_rate": args.error_rate,
+                }
+            server.control("__config", faults)
+            result = run_scenario(args, server, scenario)
+            if selected:
+                results[scenario.name] = result
+    finally:
+        server.stop()
+
+    print_results(results)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+    if args.baseline:
+        with open(args.baseline) as f:
+            regressions, changes = compare(results, json.load(f), args.max_regression)
+        if changes:
+            print("\nSlower than %s (not gated, wall time is noisy):" % args.baseline)
+            for change in changes:
+                print("  " + change)
+        if regressions:
+            print("\nRegressions compared to %s:" % args.baseline)
+            for regression in regressions:
+                print("  " + regression)
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
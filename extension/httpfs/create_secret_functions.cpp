@@ -2,6 +2,12 @@
 #include "s3fs.hpp"
 #include "duckdb/main/extension_util.hpp"
 #include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+#include <chrono>
+#include <condition_variable>
 
 namespace duckdb {
 
@@ -88,6 +94,11 @@ unique_ptr<BaseSecret> CreateS3SecretFunctions::CreateSecretFunctionInternal(Cli
 				                            lower_name, named_param.second.type().ToString());
 			}
 			secret->secret_map["url_compatibility_mode"] = Value::BOOLEAN(named_param.second.GetValue<bool>());
+		} else if (lower_name == "expiration") {
+			// Validated here so that a bad value is reported when the secret is created, not when it is used
+			auto expiration = named_param.second.ToString();
+			Timestamp::FromString(expiration);
+			secret->secret_map["expiration"] = expiration;
 		} else if (lower_name == "account_id") {
 			continue; // handled already
 		} else if (lower_name == "refresh") {
@@ -99,6 +110,10 @@ unique_ptr<BaseSecret> CreateS3SecretFunctions::CreateSecretFunctionInternal(Cli
 			child_list_t<Value> struct_fields;
 			for (const auto &named_param : input.options) {
 				auto lower_name = StringUtil::Lower(named_param.first);
+				if (lower_name == "expiration") {
+					// the expiration belongs to the current credentials, not to the ones the refresh creates
+					continue;
+				}
 				struct_fields.push_back({lower_name, named_param.second});
 			}
 			secret->secret_map["refresh_info"] = Value::STRUCT(struct_fields);
@@ -144,30 +159,89 @@ CreateSecretInput CreateS3SecretFunctions::GenerateRefreshSecretInfo(const Secre
 	auto result_child_count = StructType::GetChildCount(refresh_info.type());
 	auto refresh_info_children = StructValue::GetChildren(refresh_info);
 	D_ASSERT(refresh_info_children.size() == result_child_count);
+	bool refreshable = false;
+	vector<Value> keys;
+	vector<Value> values;
 	for (idx_t i = 0; i < result_child_count; i++) {
 		auto &key = StructType::GetChildName(refresh_info.type(), i);
 		auto &value = refresh_info_children[i];
 		result.options[key] = value;
+		auto lower_key = StringUtil::Lower(key);
+		refreshable = refreshable || lower_key == "refresh" || lower_key == "refresh_info";
+		keys.emplace_back(key);
+		values.emplace_back(value.ToString());
+	}
+	if (!refreshable) {
+		// The refreshed secret can be refreshed again in the same way: together with an EXPIRATION in the refresh
+		// info, credentials keep being renewed ahead of their expiration rather than only once
+		result.options["refresh_info"] =
+		    Value::MAP(LogicalType::VARCHAR, LogicalType::VARCHAR, std::move(keys), std::move(values));
 	}
 
 	return result;
 }
 
-//! Function that will automatically try to refresh a secret
-bool CreateS3SecretFunctions::TryRefreshS3Secret(ClientContext &context, const SecretEntry &secret_to_refresh) {
-	const auto &kv_secret = dynamic_cast<const KeyValueSecret &>(*secret_to_refresh.secret);
+//! Identifies the contents of a secret, so that a secret that was replaced can be told apart from its replacement
+static string SecretFingerprint(const KeyValueSecret &secret) {
+	string result = secret.GetType() + "|" + secret.GetProvider();
+	for (auto &entry : secret.secret_map) {
+		result += "|" + entry.first + "=" + entry.second.ToString();
+	}
+	return result;
+}
 
-	Value refresh_info;
-	if (!kv_secret.TryGetValue("refresh_info", refresh_info)) {
-		return false;
+//! Refresh state of a single secret
+struct SecretRefreshState {
+	//! Whether a refresh of the secret is in progress
+	bool in_flight = false;
+	//! The secret that was refreshed last, and the secret that replaced it
+	string refreshed_from;
+	string refreshed_to;
+	//! When the last refresh finished, and its outcome
+	std::chrono::steady_clock::time_point finished;
+	bool refreshed = false;
+	ErrorData error;
+
+	//! Whether the outcome of the last refresh applies to `fingerprint`
+	bool Covers(const string &fingerprint, std::chrono::steady_clock::time_point now) const {
+		if (refreshed_from.empty() || now - finished > std::chrono::seconds(int64_t(COOLDOWN_SECONDS))) {
+			return false;
+		}
+		return fingerprint == refreshed_from || fingerprint == refreshed_to;
+	}
+
+	//! How long the outcome of a refresh is reused for the secret that was refreshed (and for its replacement)
+	static constexpr int64_t COOLDOWN_SECONDS = 10;
+};
+
+//! Deduplicates the refreshes of the secrets of a database. When credentials expire during a scan, every thread that
+//! opens a file with them tries to refresh the secret: only one refresh per secret runs at a time, the other threads
+//! wait for its outcome, which is reused until the cooldown has passed.
+class SecretRefreshTracker : public ObjectCacheEntry {
+public:
+	static string ObjectType() {
+		return "httpfs_secret_refresh_tracker";
+	}
+	string GetObjectType() override {
+		return ObjectType();
 	}
+
+	mutex lock;
+	std::condition_variable refresh_finished;
+	//! Keyed by storage and name of the secret
+	unordered_map<string, SecretRefreshState> secrets;
+};
+
+static bool RefreshS3Secret(ClientContext &context, const SecretEntry &secret_to_refresh, Value &refresh_info,
+                            string &new_fingerprint) {
 	auto &secret_manager = context.db->GetSecretManager();
-	auto refresh_input = GenerateRefreshSecretInfo(secret_to_refresh, refresh_info);
+	auto refresh_input = CreateS3SecretFunctions::GenerateRefreshSecretInfo(secret_to_refresh, refresh_info);
 
 	// TODO: change SecretManager API to avoid requiring catching this exception
 	try {
 		auto res = secret_manager.CreateSecret(context, refresh_input);
 		auto &new_secret = dynamic_cast<const KeyValueSecret &>(*res->secret);
+		new_fingerprint = SecretFingerprint(new_secret);
 		DUCKDB_LOG_INFO(context, "Successfully refreshed secret: %s, new key_id: %s",
 		                secret_to_refresh.secret->GetName(), new_secret.TryGetValue("key_id").ToString());
 		return true;
@@ -180,6 +254,62 @@ bool CreateS3SecretFunctions::TryRefreshS3Secret(ClientContext &context, const S
 	}
 }
 
+//! Function that will automatically try to refresh a secret
+bool CreateS3SecretFunctions::TryRefreshS3Secret(ClientContext &context, const SecretEntry &secret_to_refresh) {
+	const auto &kv_secret = dynamic_cast<const KeyValueSecret &>(*secret_to_refresh.secret);
+
+	Value refresh_info;
+	if (!kv_secret.TryGetValue("refresh_info", refresh_info)) {
+		return false;
+	}
+
+	string new_fingerprint;
+	auto tracker =
+	    ObjectCache::GetObjectCache(context).GetOrCreate<SecretRefreshTracker>(SecretRefreshTracker::ObjectType());
+	if (!tracker) {
+		return RefreshS3Secret(context, secret_to_refresh, refresh_info, new_fingerprint);
+	}
+
+	auto fingerprint = SecretFingerprint(kv_secret);
+	unique_lock<mutex> guard(tracker->lock);
+	// Map entries are stable, so the state can be used while the lock is released
+	auto &state = tracker->secrets[secret_to_refresh.storage_mode + "." + kv_secret.GetName()];
+	tracker->refresh_finished.wait(guard, [&]() { return !state.in_flight; });
+	if (state.Covers(fingerprint, std::chrono::steady_clock::now())) {
+		// Refreshed (or failed to refresh) just now: re-reading the secret picks up the refreshed credentials
+		if (state.error.HasError()) {
+			auto error = state.error;
+			guard.unlock();
+			error.Throw();
+		}
+		return state.refreshed;
+	}
+
+	state.in_flight = true;
+	guard.unlock();
+	bool refreshed = false;
+	ErrorData error;
+	try {
+		refreshed = RefreshS3Secret(context, secret_to_refresh, refresh_info, new_fingerprint);
+	} catch (std::exception &ex) {
+		error = ErrorData(ex);
+	}
+	guard.lock();
+	state.in_flight = false;
+	state.refreshed_from = fingerprint;
+	state.refreshed_to = new_fingerprint;
+	state.finished = std::chrono::steady_clock::now();
+	state.refreshed = refreshed;
+	state.error = error;
+	guard.unlock();
+	tracker->refresh_finished.notify_all();
+
+	if (error.HasError()) {
+		error.Throw();
+	}
+	return refreshed;
+}
+
 unique_ptr<BaseSecret> CreateS3SecretFunctions::CreateS3SecretFromConfig(ClientContext &context,
                                                                          CreateSecretInput &input) {
 	return CreateSecretFunctionInternal(context, input);
@@ -197,6 +327,12 @@ void CreateS3SecretFunctions::SetBaseNamedParams(CreateSecretFunction &function,
 	function.named_parameters["url_compatibility_mode"] = LogicalType::BOOLEAN;
     function.named_parameters["requester_pays"] = LogicalType::BOOLEAN;
 
+	// Timestamp at which temporary credentials expire, they are refreshed ahead of it when the secret is refreshable.
+	// The refreshed credentials expire at the EXPIRATION given in REFRESH_INFO, if any. A secret refreshed with
+	// REFRESH 'auto' is created from the same options again, which would only repeat the expiration that triggered
+	// the refresh, so it has none: it is refreshed ahead of time once, and after that only when a request fails.
+	function.named_parameters["expiration"] = LogicalType::VARCHAR;
+
 	// Whether a secret refresh attempt should be made when the secret appears to be incorrect
 	function.named_parameters["refresh"] = LogicalType::VARCHAR;
 
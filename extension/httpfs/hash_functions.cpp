@@ -1,6 +1,14 @@
 #include "mbedtls_wrapper.hpp"
 #include "hash_functions.hpp"
 
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
 namespace duckdb {
 
 void sha256(const char *in, size_t in_len, hash_bytes &out) {
@@ -25,4 +33,176 @@ void hex256(hash_bytes &in, hash_str &out) {
 	}
 }
 
+// Reflected polynomials of CRC-32C and CRC-64/NVME
+static constexpr uint32_t CRC32C_POLY = 0x82F63B78;
+static constexpr uint64_t CRC64NVME_POLY = 0x9A6C9329AC4BC9B5;
+
+//! Lookup tables for table-driven CRC computation, eight bytes at a time ("slicing-by-8")
+template <class T, T POLY>
+struct CRCTables {
+	CRCTables() {
+		for (uint32_t i = 0; i < 256; i++) {
+			T crc = i;
+			for (int bit = 0; bit < 8; bit++) {
+				crc = (crc & 1) ? (crc >> 1) ^ POLY : crc >> 1;
+			}
+			table[0][i] = crc;
+		}
+		for (uint32_t i = 0; i < 256; i++) {
+			for (int slice = 1; slice < 8; slice++) {
+				table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+			}
+		}
+	}
+
+	T table[8][256];
+};
+
+template <class T, T POLY>
+static T crc_software(T crc, const char *in, size_t in_len) {
+	static const CRCTables<T, POLY> tables;
+	auto &table = tables.table;
+	auto bytes = reinterpret_cast<const uint8_t *>(in);
+	crc = ~crc;
+	while (in_len >= 8) {
+		uint64_t word = 0;
+		for (int i = 0; i < 8; i++) {
+			word |= uint64_t(bytes[i]) << (8 * i);
+		}
+		word ^= crc;
+		crc = table[7][word & 0xFF] ^ table[6][(word >> 8) & 0xFF] ^ table[5][(word >> 16) & 0xFF] ^
+		      table[4][(word >> 24) & 0xFF] ^ table[3][(word >> 32) & 0xFF] ^ table[2][(word >> 40) & 0xFF] ^
+		      table[1][(word >> 48) & 0xFF] ^ table[0][word >> 56];
+		bytes += 8;
+		in_len -= 8;
+	}
+	while (in_len-- > 0) {
+		crc = (crc >> 8) ^ table[0][(crc ^ *bytes++) & 0xFF];
+	}
+	return ~crc;
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HTTPFS_CRC32C_HARDWARE 1
+__attribute__((target("sse4.2"))) static uint32_t crc32c_hardware(uint32_t crc, const char *in, size_t in_len) {
+	uint64_t crc64 = ~crc & 0xFFFFFFFF;
+	while (in_len >= 8) {
+		uint64_t word;
+		memcpy(&word, in, sizeof(word));
+		crc64 = _mm_crc32_u64(crc64, word);
+		in += 8;
+		in_len -= 8;
+	}
+	auto crc32 = static_cast<uint32_t>(crc64);
+	while (in_len-- > 0) {
+		crc32 = _mm_crc32_u8(crc32, static_cast<uint8_t>(*in++));
+	}
+	return ~crc32;
+}
+
+static bool crc32c_hardware_available() {
+	return __builtin_cpu_supports("sse4.2");
+}
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define HTTPFS_CRC32C_HARDWARE 1
+static uint32_t crc32c_hardware(uint32_t crc, const char *in, size_t in_len) {
+	crc = ~crc;
+	while (in_len >= 8) {
+		uint64_t word;
+		memcpy(&word, in, sizeof(word));
+		crc = __crc32cd(crc, word);
+		in += 8;
+		in_len -= 8;
+	}
+	while (in_len-- > 0) {
+		crc = __crc32cb(crc, static_cast<uint8_t>(*in++));
+	}
+	return ~crc;
+}
+
+static bool crc32c_hardware_available() {
+	return true;
+}
+#endif
+
+uint32_t crc32c(uint32_t crc, const char *in, size_t in_len) {
+#ifdef HTTPFS_CRC32C_HARDWARE
+	static const bool use_hardware = crc32c_hardware_available();
+	if (use_hardware) {
+		return crc32c_hardware(crc, in, in_len);
+	}
+#endif
+	return crc_software<uint32_t, CRC32C_POLY>(crc, in, in_len);
+}
+
+uint64_t crc64nvme(uint64_t crc, const char *in, size_t in_len) {
+	return crc_software<uint64_t, CRC64NVME_POLY>(crc, in, in_len);
+}
+
+// Combining checksums works as in zlib's crc32_combine: appending len2 zero bytes to the first block is a linear
+// operation on its CRC, which is applied with a matrix over GF(2) that is squared for every bit of len2
+template <class T>
+static T gf2_matrix_times(const T *mat, T vec) {
+	T sum = 0;
+	while (vec) {
+		if (vec & 1) {
+			sum ^= *mat;
+		}
+		vec >>= 1;
+		mat++;
+	}
+	return sum;
+}
+
+template <class T>
+static void gf2_matrix_square(T *square, const T *mat) {
+	for (size_t n = 0; n < sizeof(T) * 8; n++) {
+		square[n] = gf2_matrix_times(mat, mat[n]);
+	}
+}
+
+template <class T, T POLY>
+static T crc_combine(T crc1, T crc2, size_t len2) {
+	if (len2 == 0) {
+		return crc1;
+	}
+	T even[sizeof(T) * 8];
+	T odd[sizeof(T) * 8];
+	// operator for a single zero bit
+	odd[0] = POLY;
+	T row = 1;
+	for (size_t n = 1; n < sizeof(T) * 8; n++) {
+		odd[n] = row;
+		row <<= 1;
+	}
+	// operators for two and four zero bits
+	gf2_matrix_square(even, odd);
+	gf2_matrix_square(odd, even);
+	// apply len2 zero bytes to crc1, the first square gives the operator for one zero byte
+	do {
+		gf2_matrix_square(even, odd);
+		if (len2 & 1) {
+			crc1 = gf2_matrix_times(even, crc1);
+		}
+		len2 >>= 1;
+		if (len2 == 0) {
+			break;
+		}
+		gf2_matrix_square(odd, even);
+		if (len2 & 1) {
+			crc1 = gf2_matrix_times(odd, crc1);
+		}
+		len2 >>= 1;
+	} while (len2 != 0);
+	return crc1 ^ crc2;
+}
+
+uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2) {
+	return crc_combine<uint32_t, CRC32C_POLY>(crc1, crc2, len2);
+}
+
+uint64_t crc64nvme_combine(uint64_t crc1, uint64_t crc2, size_t len2) {
+	return crc_combine<uint64_t, CRC64NVME_POLY>(crc1, crc2, len2);
+}
+
 } // namespace duckdb
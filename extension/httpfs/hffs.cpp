@@ -4,12 +4,18 @@
 #include "duckdb/common/exception/http_exception.hpp"
 #include "duckdb/common/file_opener.hpp"
 #include "http_state.hpp"
+#include "duckdb/common/operator/cast_operators.hpp"
 #include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/types/timestamp.hpp"
 #include "duckdb/main/database.hpp"
 #include "duckdb/main/secret/secret_manager.hpp"
 #include "duckdb/function/scalar/string_common.hpp"
+#include "http_parallel.hpp"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <functional>
 #include <string>
 
 #include <map>
@@ -42,18 +48,33 @@ static string ParseNextUrlFromLinkHeader(const string &link_header_content) {
 	throw IOException("Failed to parse Link header for paginated response, pagination support");
 }
 
+HFFileHandle::HFFileHandle(FileSystem &fs, ParsedHFUrl hf_url, const OpenFileInfo &file, FileOpenFlags flags,
+                           unique_ptr<HTTPParams> http_params)
+    : HTTPFileHandle(fs, file, flags, std::move(http_params)), parsed_url(std::move(hf_url)) {
+	// The tree listing provides the size and ETag of files but (without `expand=true`) no modification time. That is
+	// enough to skip the HEAD request, which for HF also means skipping the redirect of the resolve endpoint.
+	if (!initialized && file.extended_info) {
+		auto &info = file.extended_info->options;
+		if (info.find("file_size") != info.end() && info.find("etag") != info.end()) {
+			if (info.find("last_modified") == info.end()) {
+				last_modified = 0;
+			}
+			initialized = true;
+		}
+	}
+}
+
 HFFileHandle::~HFFileHandle() {};
 
 unique_ptr<HTTPClient> HFFileHandle::CreateClient() {
 	return http_params.http_util.InitializeClient(http_params, parsed_url.endpoint);
 }
 
-string HuggingFaceFileSystem::ListHFRequest(ParsedHFUrl &url, HTTPFSParams &http_params, string &next_page_url,
-                                            optional_ptr<HTTPState> state) {
+void HuggingFaceFileSystem::ListHFRequest(ParsedHFUrl &url, HTTPFSParams &http_params, string &next_page_url,
+                                          HFTreeListParser &parser, optional_ptr<HTTPState> state) {
 	HTTPHeaders header_map;
 	string link_header_result;
 
-	std::stringstream response;
 	GetRequestInfo get_request(
 	    url.endpoint, next_page_url, header_map, http_params,
 	    [&](const HTTPResponse &response) {
@@ -63,24 +84,25 @@ string HuggingFaceFileSystem::ListHFRequest(ParsedHFUrl &url, HTTPFSParams &http
 		    if (response.HasHeader("Link")) {
 			    link_header_result = response.GetHeaderValue("Link");
 		    }
+		    // a retried request restarts from the beginning of the document
+		    parser.Reset();
 		    return true;
 	    },
 	    [&](const_data_ptr_t data, idx_t data_length) {
-		    response << string(const_char_ptr_cast(data), data_length);
+		    parser.Feed(const_char_ptr_cast(data), data_length);
 		    return true;
 	    });
 	auto res = http_params.http_util.Request(get_request);
 	if (res->status != HTTPStatusCode::OK_200) {
 		throw IOException(res->GetError() + " error for HTTP GET to '" + next_page_url + "'");
 	}
+	parser.Finish();
 
 	if (!link_header_result.empty()) {
 		next_page_url = ParseNextUrlFromLinkHeader(link_header_result);
 	} else {
 		next_page_url = "";
 	}
-
-	return response.str();
 }
 
 static bool Match(vector<string>::const_iterator key, vector<string>::const_iterator key_end,
@@ -108,75 +130,339 @@ static bool Match(vector<string>::const_iterator key, vector<string>::const_iter
 	return key == key_end && pattern == pattern_end;
 }
 
-void ParseListResult(string &input, vector<string> &files, vector<string> &directories) {
-	enum parse_entry { FILE, DIR, UNKNOWN };
-	idx_t idx = 0;
-	idx_t nested = 0;
-	bool found_path;
-	parse_entry type;
-	string current_string;
-base:
-	found_path = false;
-	type = parse_entry::UNKNOWN;
-	for (; idx < input.size(); idx++) {
-		if (input[idx] == '{') {
-			idx++;
-			goto entry;
-		}
-	}
-	goto end;
-entry:
-	while (idx < input.size()) {
-		if (input[idx] == '}') {
-			if (nested) {
-				idx++;
-				nested--;
-				continue;
-			} else if (!found_path || type == parse_entry::UNKNOWN) {
-				throw IOException("Failed to parse list result");
-			} else if (type == parse_entry::FILE) {
-				files.push_back("/" + current_string);
+//! Whether any file below the directory `dir_splits` can match the pattern, i.e. whether the directory matches a
+//! prefix of the pattern that still leaves room for the file name
+static bool MayContainMatches(const vector<string> &dir_splits, const vector<string> &pattern_splits) {
+	idx_t i = 0;
+	for (; i < dir_splits.size(); i++) {
+		if (i >= pattern_splits.size()) {
+			return false;
+		}
+		auto &pattern = pattern_splits[i];
+		if (pattern == "**") {
+			return true;
+		}
+		if (!Glob(dir_splits[i].data(), dir_splits[i].length(), pattern.data(), pattern.length())) {
+			return false;
+		}
+	}
+	return i < pattern_splits.size();
+}
+
+//! A single entry of a HuggingFace tree listing
+struct HFTreeEntry {
+	bool is_directory = false;
+	string path;
+	bool has_size = false;
+	idx_t size = 0;
+	string oid;
+	//! The sha256 of the file contents, only present for files stored in LFS
+	string lfs_oid;
+	//! Only present when the listing was requested with `expand=true`
+	string last_commit_date;
+
+	void Reset() {
+		is_directory = false;
+		path.clear();
+		has_size = false;
+		size = 0;
+		oid.clear();
+		lfs_oid.clear();
+		last_commit_date.clear();
+	}
+};
+
+//! Incremental parser for the JSON array returned by the HF tree API: `[{"type": "file", "path": ..., "size": ...,
+//! "oid": ..., "lfs": {"oid": ...}, "lastCommit": {"date": ...}}, ...]`. Chunks can be fed as they arrive from the
+//! socket and may split tokens at any position. The entries of a page are only handed to the callback once the whole
+//! page was parsed (see Finish), so a request that is retried after a partial response does not report them twice.
+class HFTreeListParser {
+public:
+	explicit HFTreeListParser(std::function<void(HFTreeEntry &)> callback_p) : callback(std::move(callback_p)) {
+	}
+
+	void Feed(const char *data, idx_t length) {
+		for (idx_t i = 0; i < length; i++) {
+			ProcessCharacter(data[i]);
+		}
+	}
+
+	//! Discards the partially parsed document and its entries, e.g. when the request is retried
+	void Reset() {
+		page_entries.clear();
+		state = ParserState::VALUE;
+		depth = 0;
+		expect_key = false;
+		seen_value = false;
+		high_surrogate = 0;
+	}
+
+	//! Verifies that a complete document was parsed, reports its entries and resets the parser for the next page
+	void Finish() {
+		if (state == ParserState::LITERAL) {
+			FinishLiteral();
+		}
+		if (depth != 0 || state != ParserState::VALUE || !seen_value) {
+			throw IOException("Failed to parse list result: truncated response");
+		}
+		seen_value = false;
+		for (auto &page_entry : page_entries) {
+			callback(page_entry);
+		}
+		page_entries.clear();
+	}
+
+private:
+	enum class ParserState : uint8_t { VALUE, STRING, STRING_ESCAPE, STRING_UNICODE, LITERAL };
+	//! Entries of the listing live at depth 2 (inside the top-level array), their nested objects at depth 3
+	static constexpr idx_t ENTRY_DEPTH = 2;
+	static constexpr idx_t MAX_DEPTH = 64;
+
+	void ProcessCharacter(char c) {
+		switch (state) {
+		case ParserState::STRING:
+			if (c == '"') {
+				state = ParserState::VALUE;
+				FinishString();
+			} else if (c == '\\') {
+				state = ParserState::STRING_ESCAPE;
 			} else {
-				directories.push_back("/" + current_string);
+				token += c;
 			}
-			current_string = "";
-			idx++;
-			goto base;
-		} else if (input[idx] == '{') {
-			nested++;
-			idx++;
-		} else if (strncmp(input.c_str() + idx, "\"type\":\"directory\"", 18) == 0) {
-			type = parse_entry::DIR;
-			idx += 18;
-		} else if (strncmp(input.c_str() + idx, "\"type\":\"file\"", 13) == 0) {
-			type = parse_entry::FILE;
-			idx += 13;
-		} else if (strncmp(input.c_str() + idx, "\"path\":\"", 8) == 0) {
-			idx += 8;
-			found_path = true;
-			goto pathname;
-		} else {
-			idx++;
-		}
-	}
-	goto end;
-pathname:
-	while (idx < input.size()) {
-		// Handle escaped quote in url
-		if (input[idx] == '\\' && idx + 1 < input.size() && input[idx] == '\"') {
-			current_string += '\"';
-			idx += 2;
-		} else if (input[idx] == '\"') {
-			idx++;
-			goto entry;
+			return;
+		case ParserState::STRING_ESCAPE:
+			state = ParserState::STRING;
+			switch (c) {
+			case 'b':
+				token += '\b';
+				break;
+			case 'f':
+				token += '\f';
+				break;
+			case 'n':
+				token += '\n';
+				break;
+			case 'r':
+				token += '\r';
+				break;
+			case 't':
+				token += '\t';
+				break;
+			case 'u':
+				state = ParserState::STRING_UNICODE;
+				unicode_digits = 0;
+				unicode_value = 0;
+				break;
+			default:
+				// '"', '\\' and '/' stand for themselves
+				token += c;
+				break;
+			}
+			return;
+		case ParserState::STRING_UNICODE:
+			unicode_value = (unicode_value << 4) | HexValue(c);
+			if (++unicode_digits == 4) {
+				AppendCodePoint();
+				state = ParserState::STRING;
+			}
+			return;
+		case ParserState::LITERAL:
+			if (IsLiteralCharacter(c)) {
+				token += c;
+				return;
+			}
+			FinishLiteral();
+			state = ParserState::VALUE;
+			break;
+		case ParserState::VALUE:
+			break;
+		}
+
+		switch (c) {
+		case ' ':
+		case '\t':
+		case '\n':
+		case '\r':
+			break;
+		case '{':
+		case '[':
+			Push(c == '{');
+			break;
+		case '}':
+		case ']':
+			Pop(c == '}');
+			break;
+		case ',':
+			if (depth == 0) {
+				ThrowParseError();
+			}
+			expect_key = in_object[depth - 1];
+			break;
+		case ':':
+			if (depth == 0 || !in_object[depth - 1] || expect_key) {
+				ThrowParseError();
+			}
+			break;
+		case '"':
+			token.clear();
+			state = ParserState::STRING;
+			break;
+		default:
+			if (!IsLiteralCharacter(c) || expect_key) {
+				ThrowParseError();
+			}
+			token.clear();
+			token += c;
+			state = ParserState::LITERAL;
+			break;
+		}
+	}
+
+	void Push(bool is_object) {
+		if (expect_key || depth >= MAX_DEPTH) {
+			ThrowParseError();
+		}
+		if (depth == 0) {
+			if (is_object || seen_value) {
+				// the tree API returns an array at the top level
+				ThrowParseError();
+			}
+			seen_value = true;
+		}
+		in_object[depth] = is_object;
+		depth++;
+		expect_key = is_object;
+		if (depth == ENTRY_DEPTH) {
+			if (!is_object) {
+				ThrowParseError();
+			}
+			entry.Reset();
+			has_type = false;
+		}
+	}
+
+	void Pop(bool is_object) {
+		if (depth == 0 || in_object[depth - 1] != is_object) {
+			ThrowParseError();
+		}
+		if (depth == ENTRY_DEPTH) {
+			if (!has_type || entry.path.empty()) {
+				throw IOException("Failed to parse list result: entry without type or path");
+			}
+			page_entries.push_back(entry);
+		}
+		depth--;
+		expect_key = false;
+	}
+
+	void FinishString() {
+		if (expect_key) {
+			if (depth <= keys.size()) {
+				keys[depth - 1] = token;
+			}
+			expect_key = false;
+			return;
+		}
+		if (depth == ENTRY_DEPTH) {
+			auto &key = keys[ENTRY_DEPTH - 1];
+			if (key == "type") {
+				has_type = true;
+				entry.is_directory = token == "directory";
+			} else if (key == "path") {
+				entry.path = token;
+			} else if (key == "oid") {
+				entry.oid = token;
+			}
+		} else if (depth == ENTRY_DEPTH + 1) {
+			auto &parent_key = keys[ENTRY_DEPTH - 1];
+			auto &key = keys[ENTRY_DEPTH];
+			if (parent_key == "lfs" && key == "oid") {
+				entry.lfs_oid = token;
+			} else if (parent_key == "lastCommit" && key == "date") {
+				entry.last_commit_date = token;
+			}
+		}
+	}
+
+	void FinishLiteral() {
+		if (depth == ENTRY_DEPTH && keys[ENTRY_DEPTH - 1] == "size") {
+			char *end = nullptr;
+			auto value = strtoull(token.c_str(), &end, 10);
+			if (end && *end == '\0') {
+				entry.has_size = true;
+				entry.size = value;
+			}
+		}
+	}
+
+	void AppendCodePoint() {
+		auto code_point = unicode_value;
+		if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+			// high surrogate: wait for the low surrogate of the pair
+			high_surrogate = code_point;
+			return;
+		}
+		if (code_point >= 0xDC00 && code_point <= 0xDFFF && high_surrogate) {
+			code_point = 0x10000 + ((high_surrogate - 0xD800) << 10) + (code_point - 0xDC00);
+		}
+		high_surrogate = 0;
+		if (code_point < 0x80) {
+			token += static_cast<char>(code_point);
+		} else if (code_point < 0x800) {
+			token += static_cast<char>(0xC0 | (code_point >> 6));
+			token += static_cast<char>(0x80 | (code_point & 0x3F));
+		} else if (code_point < 0x10000) {
+			token += static_cast<char>(0xE0 | (code_point >> 12));
+			token += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+			token += static_cast<char>(0x80 | (code_point & 0x3F));
 		} else {
-			current_string += input[idx];
-			idx++;
+			token += static_cast<char>(0xF0 | (code_point >> 18));
+			token += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+			token += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+			token += static_cast<char>(0x80 | (code_point & 0x3F));
 		}
 	}
-end:
-	return;
-}
+
+	static uint32_t HexValue(char c) {
+		if (c >= '0' && c <= '9') {
+			return c - '0';
+		}
+		if (c >= 'a' && c <= 'f') {
+			return c - 'a' + 10;
+		}
+		if (c >= 'A' && c <= 'F') {
+			return c - 'A' + 10;
+		}
+		throw IOException("Failed to parse list result: invalid unicode escape");
+	}
+
+	static bool IsLiteralCharacter(char c) {
+		return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' || c == 'E';
+	}
+
+	static void ThrowParseError() {
+		throw IOException("Failed to parse list result");
+	}
+
+	std::function<void(HFTreeEntry &)> callback;
+
+	ParserState state = ParserState::VALUE;
+	idx_t depth = 0;
+	bool in_object[MAX_DEPTH] = {};
+	//! The last key seen at the entry level and one level below it
+	std::array<string, ENTRY_DEPTH + 1> keys;
+	bool expect_key = false;
+	bool seen_value = false;
+	string token;
+	idx_t unicode_digits = 0;
+	uint32_t unicode_value = 0;
+	uint32_t high_surrogate = 0;
+
+	HFTreeEntry entry;
+	bool has_type = false;
+	//! Entries of the page being parsed
+	vector<HFTreeEntry> page_entries;
+};
 
 // Some valid example Urls:
 // - hf://datasets/lhoestq/demo1/default/train/0000.parquet
@@ -209,45 +495,93 @@ vector<OpenFileInfo> HuggingFaceFileSystem::Glob(const string &path, FileOpener
 	auto params = http_util->InitializeParameters(opener, info);
 	auto &http_params = params->Cast<HTTPFSParams>();
 	SetParams(http_params, path, opener);
+	parsed_glob_url.endpoint = http_params.hf_endpoint;
 	auto http_state = HTTPState::TryGetState(opener).get();
 
-	ParsedHFUrl curr_hf_path = parsed_glob_url;
-	curr_hf_path.path = shared_path;
-
-	vector<string> files;
-	vector<string> dirs = {shared_path};
-	string next_page_url = "";
-
-	// Loop over the paths and paginated responses for each path
-	while (true) {
-		if (next_page_url.empty() && !dirs.empty()) {
-			// Done with previous dir, load the next one
-			curr_hf_path.path = dirs.back();
-			dirs.pop_back();
-			next_page_url = HuggingFaceFileSystem::GetTreeUrl(curr_hf_path, http_params.hf_max_per_page);
-		} else if (next_page_url.empty()) {
-			// No more pages to read, also no more dirs
-			break;
+	vector<string> pattern_splits = StringUtil::Split(parsed_glob_url.path, "/");
+	bool recursive = std::find(pattern_splits.begin(), pattern_splits.end(), "**") != pattern_splits.end();
+
+	// Lists a single directory (following pagination), or its entire subtree in recursive mode
+	auto list_directory = [&](const string &dir, vector<OpenFileInfo> &files, vector<string> &dirs) {
+		ParsedHFUrl dir_hf_path = parsed_glob_url;
+		dir_hf_path.path = dir;
+		HFTreeListParser parser([&](HFTreeEntry &entry) {
+			if (entry.is_directory) {
+				dirs.push_back("/" + entry.path);
+				return;
+			}
+			OpenFileInfo file("/" + entry.path);
+			auto extra_info = make_shared_ptr<ExtendedOpenFileInfo>();
+			if (entry.has_size) {
+				extra_info->options["file_size"] = Value::UBIGINT(entry.size);
+			}
+			// Files in LFS are served with their sha256 as ETag, other files with their git object id
+			auto &oid = entry.lfs_oid.empty() ? entry.oid : entry.lfs_oid;
+			if (!oid.empty()) {
+				extra_info->options["etag"] = Value("\"" + oid + "\"");
+			}
+			Value last_modified;
+			if (!entry.last_commit_date.empty() &&
+			    Value(entry.last_commit_date).DefaultTryCastAs(LogicalType::TIMESTAMP, last_modified, nullptr)) {
+				extra_info->options["last_modified"] = std::move(last_modified);
+			}
+			file.extended_info = std::move(extra_info);
+			files.push_back(std::move(file));
+		});
+		string next_page_url = GetTreeUrl(dir_hf_path, http_params.hf_max_per_page, recursive);
+		while (!next_page_url.empty()) {
+			ListHFRequest(dir_hf_path, http_params, next_page_url, parser, http_state);
 		}
+	};
 
-		auto response_str = ListHFRequest(curr_hf_path, http_params, next_page_url, http_state);
-		ParseListResult(response_str, files, dirs);
+	vector<OpenFileInfo> files;
+	if (recursive) {
+		// A '**' can match at any depth, so there is little to prune: let the server walk the tree in one listing
+		vector<string> unused_dirs;
+		list_directory(shared_path, files, unused_dirs);
+	} else {
+		// Walk the tree level by level, listing all directories of a level concurrently and only descending into
+		// directories that can still contain matches
+		vector<string> level = {shared_path};
+		mutex result_lock;
+		while (!level.empty()) {
+			vector<string> next_level;
+			HTTPParallelFor(http_params.io_executor, level.size(), http_params.hf_max_concurrent_listings, [&](idx_t i) {
+				vector<OpenFileInfo> dir_files;
+				vector<string> sub_dirs;
+				list_directory(level[i], dir_files, sub_dirs);
+
+				lock_guard<mutex> guard(result_lock);
+				for (auto &file : dir_files) {
+					files.push_back(std::move(file));
+				}
+				for (auto &sub_dir : sub_dirs) {
+					auto dir_splits = StringUtil::Split(sub_dir, "/");
+					if (MayContainMatches(dir_splits, pattern_splits)) {
+						next_level.push_back(std::move(sub_dir));
+					}
+				}
+			});
+			level = std::move(next_level);
+		}
 	}
 
-	vector<string> pattern_splits = StringUtil::Split(parsed_glob_url.path, "/");
+	ParsedHFUrl curr_hf_path = parsed_glob_url;
 	vector<OpenFileInfo> result;
-	for (const auto &file : files) {
+	for (auto &file : files) {
 
-		vector<string> file_splits = StringUtil::Split(file, "/");
+		vector<string> file_splits = StringUtil::Split(file.path, "/");
 		bool is_match = Match(file_splits.begin(), file_splits.end(), pattern_splits.begin(), pattern_splits.end());
 
 		if (is_match) {
-			curr_hf_path.path = file;
-			result.push_back(GetHFUrl(curr_hf_path));
+			curr_hf_path.path = file.path;
+			file.path = GetHFUrl(curr_hf_path);
+			result.push_back(std::move(file));
 		}
 	}
-
-	// Prune files using match
+	// Directories are listed concurrently and their files collected in the order the listings complete
+	std::sort(result.begin(), result.end(),
+	          [](const OpenFileInfo &a, const OpenFileInfo &b) { return a.path < b.path; });
 	return result;
 }
 
@@ -263,10 +597,135 @@ unique_ptr<HTTPResponse> HuggingFaceFileSystem::GetRequest(FileHandle &handle, s
 	return HTTPFileSystem::GetRequest(handle, http_url, header_map);
 }
 
+//! Extracts the value of query parameter `name` from `url`, returns false if it is not present
+static bool TryGetQueryParameter(const string &url, const string &name, string &result) {
+	auto query_start = url.find('?');
+	if (query_start == string::npos) {
+		return false;
+	}
+	for (auto &param : StringUtil::Split(url.substr(query_start + 1), '&')) {
+		auto eq = param.find('=');
+		if (eq != string::npos && param.substr(0, eq) == name) {
+			result = param.substr(eq + 1);
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool TryParseDigits(const string &str, idx_t offset, idx_t count, int32_t &result) {
+	result = 0;
+	for (idx_t i = offset; i < offset + count; i++) {
+		if (i >= str.size() || !StringUtil::CharacterIsDigit(str[i])) {
+			return false;
+		}
+		result = result * 10 + (str[i] - '0');
+	}
+	return true;
+}
+
+//! Returns the unix time at which a signed url expires, or 0 if it has no (recognized) expiry. Supports CloudFront
+//! signed urls (`Expires=<unix time>`) and S3 presigned urls (`X-Amz-Date=<yyyymmddThhmmssZ>&X-Amz-Expires=<s>`).
+static int64_t GetSignedUrlExpiry(const string &url) {
+	string value;
+	if (TryGetQueryParameter(url, "Expires", value)) {
+		int64_t expiry;
+		if (TryCast::Operation<string_t, int64_t>(string_t(value), expiry, true)) {
+			return expiry;
+		}
+	}
+	string amz_expires;
+	if (TryGetQueryParameter(url, "X-Amz-Date", value) && TryGetQueryParameter(url, "X-Amz-Expires", amz_expires)) {
+		int32_t year, month, day, hour, minute, second;
+		int64_t expires;
+		if (value.size() == 16 && value[8] == 'T' && TryParseDigits(value, 0, 4, year) &&
+		    TryParseDigits(value, 4, 2, month) && TryParseDigits(value, 6, 2, day) &&
+		    TryParseDigits(value, 9, 2, hour) && TryParseDigits(value, 11, 2, minute) &&
+		    TryParseDigits(value, 13, 2, second) && Date::IsValid(year, month, day) &&
+		    TryCast::Operation<string_t, int64_t>(string_t(amz_expires), expires, true)) {
+			auto signed_at = Timestamp::FromDatetime(Date::FromDate(year, month, day),
+			                                         Time::FromTime(hour, minute, second, 0));
+			return Timestamp::GetEpochSeconds(signed_at) + expires;
+		}
+	}
+	return 0;
+}
+
+shared_ptr<HFResolvedUrl> HuggingFaceFileSystem::GetResolvedUrl(HFFileHandle &handle) {
+	lock_guard<mutex> guard(handle.redirect_lock);
+	if (handle.resolved_url) {
+		auto expiry = handle.resolved_url->expiry;
+		auto now = Timestamp::GetEpochSeconds(Timestamp::GetCurrentTimestamp());
+		if (expiry == 0 || now + REDIRECT_EXPIRY_MARGIN < expiry) {
+			return handle.resolved_url;
+		}
+	}
+
+	// Ask the hub where the file lives, without following the redirect
+	auto &http_params = handle.http_params;
+	HTTPFSParams resolve_params(http_params);
+	resolve_params.follow_location = false;
+	auto hub_url = GetFileUrl(handle.parsed_url);
+	HTTPHeaders header_map;
+	HeadRequestInfo head_request(hub_url, header_map, resolve_params);
+	auto client = http_params.http_util.InitializeClient(resolve_params, handle.parsed_url.endpoint);
+	auto response = http_params.http_util.Request(head_request, client);
+
+	auto result = make_shared_ptr<HFResolvedUrl>(http_params);
+	auto status = static_cast<int>(response->status);
+	if (status >= 300 && status < 400 && response->HasHeader("Location")) {
+		auto location = response->GetHeaderValue("Location");
+		if (StringUtil::StartsWith(location, "/")) {
+			location = handle.parsed_url.endpoint + location;
+		}
+		string location_path, location_host, hub_path, hub_host;
+		HTTPUtil::DecomposeURL(location, location_path, location_host);
+		HTTPUtil::DecomposeURL(hub_url, hub_path, hub_host);
+		if (location_host != hub_host) {
+			// the CDN authenticates through the signature in the url
+			result->params.bearer_token.clear();
+		}
+		result->url = location;
+		result->expiry = GetSignedUrlExpiry(location);
+	} else if (!response->Success()) {
+		// leave reporting the error to the regular request
+		return nullptr;
+	}
+	handle.resolved_url = result;
+	return result;
+}
+
+void HuggingFaceFileSystem::InvalidateResolvedUrl(HFFileHandle &handle, const shared_ptr<HFResolvedUrl> &resolved) {
+	lock_guard<mutex> guard(handle.redirect_lock);
+	if (handle.resolved_url == resolved) {
+		handle.resolved_url = nullptr;
+	}
+}
+
 unique_ptr<HTTPResponse> HuggingFaceFileSystem::GetRangeRequest(FileHandle &handle, string s3_url,
                                                                 HTTPHeaders header_map, idx_t file_offset,
                                                                 char *buffer_out, idx_t buffer_out_len) {
 	auto &hf_handle = handle.Cast<HFFileHandle>();
+	if (hf_handle.http_params.hf_cache_redirects) {
+		// Send the read to where the hub would redirect it to, saving a round trip to the hub per read. If the
+		// (signed) target is rejected, it is resolved once more before giving up.
+		for (idx_t attempt = 0; attempt < 2; attempt++) {
+			auto resolved = GetResolvedUrl(hf_handle);
+			if (!resolved || resolved->url.empty()) {
+				break;
+			}
+			try {
+				return HTTPFileSystem::GetRangeRequest(hf_handle, resolved->params, &resolved->clients, resolved->url,
+				                                       header_map, file_offset, buffer_out, buffer_out_len);
+			} catch (HTTPException &ex) {
+				auto status = ex.GetStatusCode();
+				if (attempt > 0 || (status != 403 && status != 410)) {
+					throw;
+				}
+				InvalidateResolvedUrl(hf_handle, resolved);
+			}
+		}
+	}
 	auto http_url = HuggingFaceFileSystem::GetFileUrl(hf_handle.parsed_url);
 	return HTTPFileSystem::GetRangeRequest(handle, http_url, header_map, file_offset, buffer_out, buffer_out_len);
 }
@@ -282,7 +741,9 @@ unique_ptr<HTTPFileHandle> HuggingFaceFileSystem::CreateHandle(const OpenFileInf
 
 	auto http_util = HTTPFSUtil::GetHTTPUtil(opener);
 	auto params = http_util->InitializeParameters(opener, info);
-	SetParams(params->Cast<HTTPFSParams>(), file.path, opener);
+	auto &http_params = params->Cast<HTTPFSParams>();
+	SetParams(http_params, file.path, opener);
+	parsed_url.endpoint = http_params.hf_endpoint;
 
 	return duckdb::make_uniq<HFFileHandle>(*this, std::move(parsed_url), file, flags, std::move(params));
 }
@@ -366,7 +827,7 @@ string HuggingFaceFileSystem::GetHFUrl(const ParsedHFUrl &url) {
 	}
 }
 
-string HuggingFaceFileSystem::GetTreeUrl(const ParsedHFUrl &url, idx_t limit) {
+string HuggingFaceFileSystem::GetTreeUrl(const ParsedHFUrl &url, idx_t limit, bool recursive) {
 	//! Url format {endpoint}/api/{repo_type}/{repository}/tree/{revision}{encoded_path_in_repo}
 	string http_url = url.endpoint;
 
@@ -377,8 +838,15 @@ string HuggingFaceFileSystem::GetTreeUrl(const ParsedHFUrl &url, idx_t limit) {
 	http_url = JoinPath(http_url, url.revision);
 	http_url += url.path;
 
+	vector<string> query_params;
 	if (limit > 0) {
-		http_url += "?limit=" + to_string(limit);
+		query_params.push_back("limit=" + to_string(limit));
+	}
+	if (recursive) {
+		query_params.push_back("recursive=true");
+	}
+	if (!query_params.empty()) {
+		http_url += "?" + StringUtil::Join(query_params, "&");
 	}
 
 	return http_url;
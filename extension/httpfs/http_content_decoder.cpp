@@ -0,0 +1,251 @@
+#include "http_content_decoder.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/limits.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "miniz.hpp"
+#include "zstd.h"
+
+#include <cstring>
+
+namespace duckdb {
+
+//! Size of the buffer that decoded data is written to before it is passed on
+static constexpr idx_t DECODE_BUFFER_SIZE = 128 * 1024;
+
+//! Decodes a gzip body (RFC 1952), which may consist of several concatenated members. The members are inflated with
+//! miniz, which does not handle the gzip framing itself: headers are parsed here and the trailers are skipped.
+class GZipContentDecoder : public HTTPContentDecoder {
+public:
+	explicit GZipContentDecoder(string url_p)
+	    : url(std::move(url_p)), output(make_unsafe_uniq_array<data_t>(DECODE_BUFFER_SIZE)) {
+	}
+	~GZipContentDecoder() override {
+		EndStream();
+	}
+
+	void Decode(const_data_ptr_t data, idx_t length, const sink_t &sink) override {
+		while (length > 0) {
+			switch (phase) {
+			case Phase::HEADER: {
+				// the header has a variable size: collect bytes until it is complete
+				auto consumed = MinValue<idx_t>(length, MAX_HEADER_CHUNK);
+				header.append(const_char_ptr_cast(data), consumed);
+				idx_t header_size;
+				if (!TryParseHeader(header_size)) {
+					data += consumed;
+					length -= consumed;
+					break;
+				}
+				// hand back the bytes after the header
+				auto excess = header.size() - header_size;
+				data += consumed - excess;
+				length -= consumed - excess;
+				header.clear();
+				StartStream();
+				phase = Phase::BODY;
+				break;
+			}
+			case Phase::BODY: {
+				auto consumed = Inflate(data, length, sink);
+				if (consumed == 0 && phase == Phase::BODY) {
+					throw IOException("Failed to decode gzip response from \"%s\": corrupt data", url);
+				}
+				data += consumed;
+				length -= consumed;
+				break;
+			}
+			case Phase::TRAILER: {
+				// CRC32 and size of the member, which are not verified
+				auto consumed = MinValue<idx_t>(length, GZIP_TRAILER_SIZE - trailer_bytes);
+				trailer_bytes += consumed;
+				data += consumed;
+				length -= consumed;
+				if (trailer_bytes == GZIP_TRAILER_SIZE) {
+					trailer_bytes = 0;
+					members++;
+					phase = Phase::HEADER;
+				}
+				break;
+			}
+			}
+		}
+	}
+
+	void Finish() override {
+		if (phase != Phase::HEADER || !header.empty() || members == 0) {
+			throw IOException("Failed to decode gzip response from \"%s\": the body is truncated", url);
+		}
+	}
+
+private:
+	enum class Phase : uint8_t { HEADER, BODY, TRAILER };
+
+	static constexpr idx_t GZIP_HEADER_MIN_SIZE = 10;
+	static constexpr idx_t GZIP_TRAILER_SIZE = 8;
+	static constexpr idx_t MAX_HEADER_CHUNK = 1024;
+	static constexpr uint8_t GZIP_FLAG_HCRC = 0x2;
+	static constexpr uint8_t GZIP_FLAG_EXTRA = 0x4;
+	static constexpr uint8_t GZIP_FLAG_NAME = 0x8;
+	static constexpr uint8_t GZIP_FLAG_COMMENT = 0x10;
+
+	//! Returns false if `header` does not hold the complete header yet, sets `header_size` otherwise
+	bool TryParseHeader(idx_t &header_size) {
+		if (header.size() < GZIP_HEADER_MIN_SIZE) {
+			return false;
+		}
+		auto bytes = const_data_ptr_cast(header.data());
+		if (bytes[0] != 0x1F || bytes[1] != 0x8B || bytes[2] != 8) {
+			throw IOException("Failed to decode gzip response from \"%s\": invalid gzip header", url);
+		}
+		auto flags = bytes[3];
+		idx_t offset = GZIP_HEADER_MIN_SIZE;
+		if (flags & GZIP_FLAG_EXTRA) {
+			if (header.size() < offset + 2) {
+				return false;
+			}
+			offset += 2 + (bytes[offset] | (bytes[offset + 1] << 8));
+		}
+		for (auto flag : {GZIP_FLAG_NAME, GZIP_FLAG_COMMENT}) {
+			if (!(flags & flag)) {
+				continue;
+			}
+			// zero-terminated string
+			auto end = offset < header.size() ? header.find('\0', offset) : string::npos;
+			if (end == string::npos) {
+				return false;
+			}
+			offset = end + 1;
+		}
+		if (flags & GZIP_FLAG_HCRC) {
+			offset += 2;
+		}
+		if (header.size() < offset) {
+			return false;
+		}
+		header_size = offset;
+		return true;
+	}
+
+	void StartStream() {
+		memset(&stream, 0, sizeof(stream));
+		if (duckdb_miniz::mz_inflateInit2(&stream, -MZ_DEFAULT_WINDOW_BITS) != duckdb_miniz::MZ_OK) {
+			throw InternalException("Failed to initialize miniz");
+		}
+		stream_initialized = true;
+	}
+
+	void EndStream() {
+		if (stream_initialized) {
+			duckdb_miniz::mz_inflateEnd(&stream);
+			stream_initialized = false;
+		}
+	}
+
+	//! Inflates (part of) the input, returning the number of bytes consumed
+	idx_t Inflate(const_data_ptr_t data, idx_t length, const sink_t &sink) {
+		stream.next_in = data;
+		stream.avail_in = UnsafeNumericCast<unsigned int>(MinValue<idx_t>(length, NumericLimits<uint32_t>::Maximum()));
+		auto available = stream.avail_in;
+		while (true) {
+			stream.next_out = output.get();
+			stream.avail_out = UnsafeNumericCast<unsigned int>(DECODE_BUFFER_SIZE);
+			auto ret = duckdb_miniz::mz_inflate(&stream, duckdb_miniz::MZ_NO_FLUSH);
+			if (ret != duckdb_miniz::MZ_OK && ret != duckdb_miniz::MZ_STREAM_END && ret != duckdb_miniz::MZ_BUF_ERROR) {
+				throw IOException("Failed to decode gzip response from \"%s\": %s", url,
+				                  duckdb_miniz::mz_error(ret));
+			}
+			auto decoded = DECODE_BUFFER_SIZE - stream.avail_out;
+			if (decoded > 0) {
+				sink(output.get(), decoded);
+			}
+			if (ret == duckdb_miniz::MZ_STREAM_END) {
+				EndStream();
+				phase = Phase::TRAILER;
+				break;
+			}
+			if ((stream.avail_in == 0 && stream.avail_out > 0) || (ret == duckdb_miniz::MZ_BUF_ERROR && decoded == 0)) {
+				// all input consumed and all output flushed
+				break;
+			}
+		}
+		return available - stream.avail_in;
+	}
+
+	string url;
+	Phase phase = Phase::HEADER;
+	//! Bytes of the header of the current member, while it is incomplete
+	string header;
+	idx_t trailer_bytes = 0;
+	idx_t members = 0;
+	duckdb_miniz::mz_stream stream;
+	bool stream_initialized = false;
+	unsafe_unique_array<data_t> output;
+};
+
+//! Decodes a zstd body (RFC 8878), which may consist of several frames
+class ZstdContentDecoder : public HTTPContentDecoder {
+public:
+	explicit ZstdContentDecoder(string url_p)
+	    : url(std::move(url_p)), stream(duckdb_zstd::ZSTD_createDStream()),
+	      output(make_unsafe_uniq_array<data_t>(DECODE_BUFFER_SIZE)) {
+		if (!stream) {
+			throw InternalException("Failed to create zstd decompression stream");
+		}
+		duckdb_zstd::ZSTD_initDStream(stream);
+	}
+	~ZstdContentDecoder() override {
+		duckdb_zstd::ZSTD_freeDStream(stream);
+	}
+
+	void Decode(const_data_ptr_t data, idx_t length, const sink_t &sink) override {
+		duckdb_zstd::ZSTD_inBuffer in_buffer {data, length, 0};
+		// keep going until the input is consumed and the decoder has no more output to flush: the decoder may hold
+		// more output whenever it filled the output buffer
+		bool output_pending = false;
+		while (in_buffer.pos < in_buffer.size || output_pending) {
+			duckdb_zstd::ZSTD_outBuffer out_buffer {output.get(), DECODE_BUFFER_SIZE, 0};
+			auto ret = duckdb_zstd::ZSTD_decompressStream(stream, &out_buffer, &in_buffer);
+			if (duckdb_zstd::ZSTD_isError(ret)) {
+				throw IOException("Failed to decode zstd response from \"%s\": %s", url,
+				                  duckdb_zstd::ZSTD_getErrorName(ret));
+			}
+			if (out_buffer.pos > 0) {
+				sink(output.get(), out_buffer.pos);
+			}
+			// 0 means a frame was completely decoded and flushed
+			frame_complete = ret == 0;
+			output_pending = out_buffer.pos == out_buffer.size;
+		}
+	}
+
+	void Finish() override {
+		if (!frame_complete) {
+			throw IOException("Failed to decode zstd response from \"%s\": the body is truncated", url);
+		}
+	}
+
+private:
+	string url;
+	duckdb_zstd::ZSTD_DStream *stream;
+	unsafe_unique_array<data_t> output;
+	bool frame_complete = false;
+};
+
+unique_ptr<HTTPContentDecoder> HTTPContentDecoder::Create(const string &url, const string &content_encoding) {
+	auto encoding = StringUtil::Lower(content_encoding);
+	StringUtil::Trim(encoding);
+	if (encoding.empty() || encoding == "identity") {
+		return nullptr;
+	}
+	if (encoding == "gzip" || encoding == "x-gzip") {
+		return make_uniq<GZipContentDecoder>(url);
+	}
+	if (encoding == "zstd") {
+		return make_uniq<ZstdContentDecoder>(url);
+	}
+	throw IOException("Unable to decode response from \"%s\": unsupported Content-Encoding \"%s\"", url,
+	                  content_encoding);
+}
+
+} // namespace duckdb
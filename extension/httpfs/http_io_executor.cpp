@@ -0,0 +1,165 @@
+#include "http_io_executor.hpp"
+
+namespace duckdb {
+
+HTTPIOExecutor::HTTPIOExecutor(idx_t max_threads) : max_threads(MaxValue<idx_t>(max_threads, 1)) {
+}
+
+HTTPIOExecutor::~HTTPIOExecutor() {
+	std::deque<Task> cancelled;
+	{
+		lock_guard<mutex> guard(lock);
+		shutdown = true;
+		std::swap(cancelled, tasks);
+	}
+	task_available.notify_all();
+	// Queued tasks do not run anymore: their callers may be waiting for them (e.g. asynchronous reads that are about to
+	// be reported on a completion queue), so they are cancelled rather than dropped
+	for (auto &task : cancelled) {
+		if (!task.cancel) {
+			continue;
+		}
+		try {
+			task.cancel();
+		} catch (std::exception &) { // NOLINT
+		}
+	}
+	cancelled.clear();
+	for (auto &worker : threads) {
+		worker.join();
+	}
+}
+
+void HTTPIOExecutor::ScheduleInternal(Task task) {
+	tasks.push_back(std::move(task));
+	if (idle_threads < tasks.size() && threads.size() < max_threads) {
+		threads.emplace_back(&HTTPIOExecutor::WorkerLoop, this);
+	}
+}
+
+void HTTPIOExecutor::Schedule(std::function<void()> task, std::function<void()> cancel) {
+	{
+		lock_guard<mutex> guard(lock);
+		ScheduleInternal(Task {std::move(task), std::move(cancel)});
+	}
+	task_available.notify_one();
+}
+
+bool HTTPIOExecutor::TrySchedule(std::function<void()> task, std::function<void()> cancel) {
+	{
+		lock_guard<mutex> guard(lock);
+		if (idle_threads <= tasks.size() && threads.size() >= max_threads) {
+			return false;
+		}
+		ScheduleInternal(Task {std::move(task), std::move(cancel)});
+	}
+	task_available.notify_one();
+	return true;
+}
+
+void HTTPIOExecutor::SetMaxThreads(idx_t max_threads_p) {
+	lock_guard<mutex> guard(lock);
+	max_threads = MaxValue<idx_t>(max_threads_p, 1);
+}
+
+idx_t HTTPIOExecutor::ThreadCount() {
+	lock_guard<mutex> guard(lock);
+	return threads.size();
+}
+
+void HTTPIOExecutor::WorkerLoop() {
+	unique_lock<mutex> guard(lock);
+	while (true) {
+		idle_threads++;
+		task_available.wait(guard, [&]() { return shutdown || !tasks.empty(); });
+		idle_threads--;
+		if (shutdown) {
+			return;
+		}
+		auto task = std::move(tasks.front().run);
+		tasks.pop_front();
+		guard.unlock();
+		try {
+			task();
+		} catch (std::exception &) { // NOLINT
+			// Tasks report their errors through their own state
+		}
+		// Release whatever the task captured before waiting for the next one
+		task = nullptr;
+		guard.lock();
+	}
+}
+
+HTTPCompletionQueue::~HTTPCompletionQueue() {
+	unique_lock<mutex> guard(lock);
+	completion.wait(guard, [&]() { return in_flight == 0; });
+}
+
+idx_t HTTPCompletionQueue::PopCompletion(unique_lock<mutex> &guard) {
+	auto entry = std::move(completed.front());
+	completed.pop_front();
+	if (entry.second.HasError()) {
+		guard.unlock();
+		entry.second.Throw();
+	}
+	return entry.first;
+}
+
+bool HTTPCompletionQueue::Next(idx_t &tag) {
+	unique_lock<mutex> guard(lock);
+	completion.wait(guard, [&]() { return !completed.empty() || in_flight == 0; });
+	if (completed.empty()) {
+		return false;
+	}
+	tag = PopCompletion(guard);
+	return true;
+}
+
+bool HTTPCompletionQueue::TryNext(idx_t &tag) {
+	unique_lock<mutex> guard(lock);
+	if (completed.empty()) {
+		return false;
+	}
+	tag = PopCompletion(guard);
+	return true;
+}
+
+void HTTPCompletionQueue::WaitAll() {
+	idx_t tag;
+	ErrorData error;
+	while (true) {
+		try {
+			if (!Next(tag)) {
+				break;
+			}
+		} catch (std::exception &ex) {
+			if (!error.HasError()) {
+				error = ErrorData(ex);
+			}
+		}
+	}
+	if (error.HasError()) {
+		error.Throw();
+	}
+}
+
+idx_t HTTPCompletionQueue::Outstanding() {
+	lock_guard<mutex> guard(lock);
+	return in_flight + completed.size();
+}
+
+void HTTPCompletionQueue::Start() {
+	lock_guard<mutex> guard(lock);
+	in_flight++;
+}
+
+void HTTPCompletionQueue::Complete(idx_t tag, ErrorData error) {
+	// Notify under the lock: once the last read is completed, the queue may be destroyed as soon as it is released
+	lock_guard<mutex> guard(lock);
+	D_ASSERT(in_flight > 0);
+	in_flight--;
+	completed.emplace_back(tag, std::move(error));
+	completion.notify_all();
+}
+
+} // namespace duckdb
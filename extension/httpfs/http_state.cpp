@@ -46,6 +46,92 @@ void CachedFileHandle::Write(const char *buffer, idx_t length, idx_t offset) {
 	memcpy(file->data.get() + offset, buffer, length);
 }
 
+void HTTPOperationStats::Reset() {
+	request_count = 0;
+	retry_count = 0;
+	new_connection_count = 0;
+	reused_connection_count = 0;
+	bytes_sent = 0;
+	bytes_received = 0;
+	time_to_first_byte.Reset();
+	total_time.Reset();
+}
+
+void HTTPGlobalStatsEntry::Add(const HTTPGlobalStatsEntry &other) {
+	request_count += other.request_count;
+	retry_count += other.retry_count;
+	new_connection_count += other.new_connection_count;
+	reused_connection_count += other.reused_connection_count;
+	bytes_sent += other.bytes_sent;
+	bytes_received += other.bytes_received;
+	total_micros += other.total_micros;
+}
+
+void HTTPGlobalStats::Record(const HTTPGlobalStatsKey &key, const HTTPGlobalStatsEntry &request) {
+	lock_guard<mutex> guard(lock);
+	entries[key].Add(request);
+}
+
+vector<pair<HTTPGlobalStatsKey, HTTPGlobalStatsEntry>> HTTPGlobalStats::GetEntries(bool reset) {
+	lock_guard<mutex> guard(lock);
+	vector<pair<HTTPGlobalStatsKey, HTTPGlobalStatsEntry>> result(entries.begin(), entries.end());
+	if (reset) {
+		entries.clear();
+	}
+	return result;
+}
+
+string HTTPState::OperationToString(HTTPOperation op) {
+	switch (op) {
+	case HTTPOperation::HEAD_OP:
+		return "HEAD";
+	case HTTPOperation::GET_OP:
+		return "GET";
+	case HTTPOperation::PUT_OP:
+		return "PUT";
+	case HTTPOperation::POST_OP:
+		return "POST";
+	case HTTPOperation::DELETE_OP:
+		return "DELETE";
+	default:
+		throw InternalException("Unknown HTTPOperation");
+	}
+}
+
+void HTTPState::QueryEnd(ClientContext &context) {
+	vector<pair<HTTPOperation, HTTPOperationStatsSnapshot>> stats;
+	for (idx_t i = 0; i < HTTP_OPERATION_COUNT; i++) {
+		auto &op_stats = operation_stats[i];
+		if (op_stats.request_count == 0) {
+			continue;
+		}
+		HTTPOperationStatsSnapshot snapshot;
+		snapshot.request_count = op_stats.request_count;
+		snapshot.retry_count = op_stats.retry_count;
+		snapshot.new_connection_count = op_stats.new_connection_count;
+		snapshot.reused_connection_count = op_stats.reused_connection_count;
+		snapshot.bytes_sent = op_stats.bytes_sent;
+		snapshot.bytes_received = op_stats.bytes_received;
+		snapshot.ttfb_p50_micros = op_stats.time_to_first_byte.Percentile(0.5);
+		snapshot.ttfb_p99_micros = op_stats.time_to_first_byte.Percentile(0.99);
+		snapshot.total_p50_micros = op_stats.total_time.Percentile(0.5);
+		snapshot.total_p99_micros = op_stats.total_time.Percentile(0.99);
+		snapshot.total_micros = op_stats.total_time.TotalMicros();
+		stats.emplace_back(static_cast<HTTPOperation>(i), snapshot);
+	}
+	// Queries without HTTP requests (such as the one reading the statistics) leave the last statistics in place
+	if (!stats.empty()) {
+		lock_guard<mutex> guard(last_query_lock);
+		last_query_stats = std::move(stats);
+	}
+	Reset();
+}
+
+vector<pair<HTTPOperation, HTTPOperationStatsSnapshot>> HTTPState::GetLastQueryStats() {
+	lock_guard<mutex> guard(last_query_lock);
+	return last_query_stats;
+}
+
 void HTTPState::Reset() {
 	// Reset Counters
 	head_count = 0;
@@ -55,6 +141,10 @@ void HTTPState::Reset() {
 	delete_count = 0;
 	total_bytes_received = 0;
 	total_bytes_sent = 0;
+	hedged_request_count = 0;
+	for (auto &op_stats : operation_stats) {
+		op_stats.Reset();
+	}
 
 	// Reset cached files
 	cached_files.clear();
@@ -72,6 +162,16 @@ shared_ptr<HTTPState> HTTPState::TryGetState(optional_ptr<FileOpener> opener) {
 	return nullptr;
 }
 
+static string FormatMicros(idx_t micros) {
+	if (micros < 1000) {
+		return to_string(micros) + "us";
+	}
+	if (micros < 1000000) {
+		return StringUtil::Format("%.1fms", static_cast<double>(micros) / 1000);
+	}
+	return StringUtil::Format("%.2fs", static_cast<double>(micros) / 1000000);
+}
+
 void HTTPState::WriteProfilingInformation(std::ostream &ss) {
 	string read = "in: " + StringUtil::BytesToHumanReadableString(total_bytes_received);
 	string written = "out: " + StringUtil::BytesToHumanReadableString(total_bytes_sent);
@@ -80,6 +180,7 @@ void HTTPState::WriteProfilingInformation(std::ostream &ss) {
 	string put = "#PUT: " + to_string(put_count);
 	string post = "#POST: " + to_string(post_count);
 	string del = "#DELETE: " + to_string(delete_count);
+	string hedged = "#Hedged GET: " + to_string(hedged_request_count);
 
 	constexpr idx_t TOTAL_BOX_WIDTH = 39;
 	ss << "┌─────────────────────────────────────┐\n";
@@ -93,6 +194,41 @@ void HTTPState::WriteProfilingInformation(std::ostream &ss) {
 	ss << "││" + QueryProfiler::DrawPadded(put, TOTAL_BOX_WIDTH - 4) + "││\n";
 	ss << "││" + QueryProfiler::DrawPadded(post, TOTAL_BOX_WIDTH - 4) + "││\n";
 	ss << "││" + QueryProfiler::DrawPadded(del, TOTAL_BOX_WIDTH - 4) + "││\n";
+	if (hedged_request_count > 0) {
+		ss << "││" + QueryProfiler::DrawPadded(hedged, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
+	idx_t retries = 0;
+	idx_t new_connections = 0;
+	idx_t reused_connections = 0;
+	vector<string> latencies;
+	for (idx_t i = 0; i < HTTP_OPERATION_COUNT; i++) {
+		auto &op_stats = operation_stats[i];
+		if (op_stats.request_count == 0) {
+			continue;
+		}
+		retries += op_stats.retry_count;
+		new_connections += op_stats.new_connection_count;
+		reused_connections += op_stats.reused_connection_count;
+		auto op = OperationToString(static_cast<HTTPOperation>(i));
+		latencies.push_back(StringUtil::Format("%s first byte: %s/%s", op,
+		                                       FormatMicros(op_stats.time_to_first_byte.Percentile(0.5)),
+		                                       FormatMicros(op_stats.time_to_first_byte.Percentile(0.99))));
+		latencies.push_back(StringUtil::Format("%s total: %s/%s", op,
+		                                       FormatMicros(op_stats.total_time.Percentile(0.5)),
+		                                       FormatMicros(op_stats.total_time.Percentile(0.99))));
+	}
+	if (!latencies.empty()) {
+		string retried = "#Retries: " + to_string(retries);
+		string connections =
+		    "#Connections new/reused: " + to_string(new_connections) + "/" + to_string(reused_connections);
+		ss << "││" + QueryProfiler::DrawPadded(retried, TOTAL_BOX_WIDTH - 4) + "││\n";
+		ss << "││" + QueryProfiler::DrawPadded(connections, TOTAL_BOX_WIDTH - 4) + "││\n";
+		ss << "││                                   ││\n";
+		ss << "││" + QueryProfiler::DrawPadded("Latency p50/p99", TOTAL_BOX_WIDTH - 4) + "││\n";
+		for (auto &line : latencies) {
+			ss << "││" + QueryProfiler::DrawPadded(line, TOTAL_BOX_WIDTH - 4) + "││\n";
+		}
+	}
 	ss << "│└───────────────────────────────────┘│\n";
 	ss << "└─────────────────────────────────────┘\n";
 }
@@ -0,0 +1,122 @@
+#include "http_streaming_upload.hpp"
+
+#include "duckdb/common/exception/http_exception.hpp"
+
+namespace duckdb {
+
+//! Chunks are large enough to keep the per-chunk overhead negligible, and small enough that the request is fed steadily
+static constexpr idx_t MAX_CHUNK_SIZE = 1024 * 1024;
+
+HTTPStreamingUpload::HTTPStreamingUpload(HTTPFSUtil &http_util, HTTPFSParams &params, string url_p,
+                                         HTTPHeaders headers_p)
+    : http_util(http_util), params(params), url(std::move(url_p)), headers(std::move(headers_p)) {
+	buffer_size = MaxValue<idx_t>(params.write_buffer_size, 1);
+	chunk_size = MaxValue<idx_t>(MinValue<idx_t>(buffer_size / 4, MAX_CHUNK_SIZE), 1);
+	request_thread = thread(&HTTPStreamingUpload::RunRequest, this);
+}
+
+HTTPStreamingUpload::~HTTPStreamingUpload() {
+	if (!request_thread.joinable()) {
+		return;
+	}
+	{
+		lock_guard<mutex> guard(lock);
+		aborted = true;
+	}
+	chunk_available.notify_all();
+	request_thread.join();
+}
+
+void HTTPStreamingUpload::Write(const_data_ptr_t data, idx_t length) {
+	while (length > 0) {
+		auto to_copy = MinValue<idx_t>(length, chunk_size - current_chunk.size());
+		current_chunk.append(const_char_ptr_cast(data), to_copy);
+		data += to_copy;
+		length -= to_copy;
+		if (current_chunk.size() >= chunk_size) {
+			PushChunk();
+		}
+	}
+}
+
+void HTTPStreamingUpload::PushChunk() {
+	unique_lock<mutex> guard(lock);
+	space_available.wait(guard, [&]() {
+		return request_done || buffered_bytes == 0 || buffered_bytes + current_chunk.size() <= buffer_size;
+	});
+	if (request_done) {
+		// the server responded (or the connection failed) before it received the whole body
+		ThrowRequestError();
+		throw IOException("Unable to upload to \"%s\": the server responded before the upload was complete", url);
+	}
+	buffered_bytes += current_chunk.size();
+	chunks.push_back(std::move(current_chunk));
+	current_chunk = string();
+	guard.unlock();
+	chunk_available.notify_one();
+}
+
+bool HTTPStreamingUpload::NextChunk(string &chunk) {
+	unique_lock<mutex> guard(lock);
+	chunk_available.wait(guard, [&]() { return aborted || body_complete || !chunks.empty(); });
+	if (aborted) {
+		throw IOException("Upload to \"%s\" was aborted", url);
+	}
+	if (chunks.empty()) {
+		return false;
+	}
+	chunk = std::move(chunks.front());
+	chunks.pop_front();
+	buffered_bytes -= chunk.size();
+	guard.unlock();
+	space_available.notify_one();
+	return true;
+}
+
+void HTTPStreamingUpload::RunRequest() {
+	unique_ptr<HTTPResponse> result;
+	ErrorData result_error;
+	try {
+		result = http_util.SendStreamingRequest(params, params.write_method, url, headers,
+		                                        [this](string &chunk) { return NextChunk(chunk); });
+	} catch (std::exception &ex) {
+		result_error = ErrorData(ex);
+	}
+	{
+		lock_guard<mutex> guard(lock);
+		response = std::move(result);
+		error = std::move(result_error);
+		request_done = true;
+	}
+	space_available.notify_all();
+}
+
+void HTTPStreamingUpload::ThrowRequestError() {
+	if (error.HasError()) {
+		error.Throw();
+	}
+	if (!response || response->HasRequestError()) {
+		auto request_error = response ? response->GetRequestError() : string("no response");
+		throw IOException("Unable to upload to \"%s\": %s", url, request_error);
+	}
+	if (!response->Success()) {
+		throw HTTPException(*response, "Unable to upload to \"%s\": %d (%s)", url,
+		                    static_cast<int>(response->status), response->GetError());
+	}
+}
+
+void HTTPStreamingUpload::Finish() {
+	if (!current_chunk.empty()) {
+		PushChunk();
+	}
+	{
+		lock_guard<mutex> guard(lock);
+		body_complete = true;
+	}
+	chunk_available.notify_one();
+	request_thread.join();
+	// Any 2xx is fine: plain PUT and POST endpoints respond with 200, WebDAV servers with 201 or 204
+	ThrowRequestError();
+}
+
+} // namespace duckdb
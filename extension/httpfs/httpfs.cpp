@@ -5,6 +5,7 @@
 #include "duckdb/common/file_opener.hpp"
 #include "duckdb/common/helper.hpp"
 #include "duckdb/common/http_util.hpp"
+#include "duckdb/common/operator/cast_operators.hpp"
 #include "duckdb/common/thread.hpp"
 #include "duckdb/common/types/hash.hpp"
 #include "duckdb/function/scalar/strftime_format.hpp"
@@ -12,9 +13,15 @@
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/database.hpp"
 #include "duckdb/main/secret/secret_manager.hpp"
+#include "http_content_decoder.hpp"
+#include "http_io_executor.hpp"
+#include "http_parallel.hpp"
+#include "http_params_cache.hpp"
 #include "http_state.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <map>
 #include <string>
 #include <thread>
@@ -38,6 +45,20 @@ unique_ptr<HTTPParams> HTTPFSUtil::InitializeParameters(optional_ptr<FileOpener>
 		return std::move(result);
 	}
 
+	// Resolving the parameters takes a few dozen setting and secret lookups, which only need to happen once per query
+	// for all files that match the same secrets
+	const char *secret_types[] = {"http"};
+	auto cache = HTTPParamsCache<HTTPFSParams>::TryGetCache(opener, "httpfs_params_cache");
+	string cache_key;
+	if (cache && cache->TryGetSecretMatchKey(opener, info ? info->file_path : string(), secret_types, 1, cache_key)) {
+		auto cached = cache->TryGet(cache_key);
+		if (cached) {
+			return unique_ptr<HTTPParams>(std::move(cached));
+		}
+	} else {
+		cache = nullptr;
+	}
+
 	Value value;
 
 	// Setting lookups
@@ -51,6 +72,36 @@ unique_ptr<HTTPParams> HTTPFSUtil::InitializeParameters(optional_ptr<FileOpener>
 	                                 info);
 	FileOpener::TryGetCurrentSetting(opener, "ca_cert_file", result->ca_cert_file, info);
 	FileOpener::TryGetCurrentSetting(opener, "hf_max_per_page", result->hf_max_per_page, info);
+	FileOpener::TryGetCurrentSetting(opener, "hf_max_concurrent_listings", result->hf_max_concurrent_listings, info);
+	FileOpener::TryGetCurrentSetting(opener, "hf_cache_redirects", result->hf_cache_redirects, info);
+	FileOpener::TryGetCurrentSetting(opener, "hf_endpoint", result->hf_endpoint, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_connection_pool_size", result->connection_pool_size, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_prewarm_connections", result->prewarm_connections, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_tail_prefetch_size", result->tail_prefetch_size, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_max_ranges_per_request", result->max_ranges_per_request, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_read_coalesce_gap", result->read_coalesce_gap, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_read_ranges_concurrency", result->read_ranges_concurrency, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_probe_read_size", result->probe_read_size, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_hedge_percentile", result->hedge_percentile, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_adaptive_concurrency", result->adaptive_concurrency, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_max_concurrent_requests", result->max_concurrent_requests, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_concurrency_per_prefix", result->concurrency_per_prefix, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_io_threads", result->io_threads, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_write_method", result->write_method, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_write_buffer_size", result->write_buffer_size, info);
+	FileOpener::TryGetCurrentSetting(opener, "http_compressed_downloads", result->compressed_downloads, info);
+	result->io_executor = &GetIOExecutor(result->io_threads);
+	if (result->hedge_percentile < 0 || result->hedge_percentile >= 1) {
+		throw InvalidInputException("http_hedge_percentile must be between 0 (disabled) and 1 (exclusive), got %f",
+		                            result->hedge_percentile);
+	}
+	result->write_method = StringUtil::Upper(result->write_method);
+	while (StringUtil::EndsWith(result->hf_endpoint, "/")) {
+		result->hf_endpoint.pop_back();
+	}
+	if (result->write_method != "PUT" && result->write_method != "POST") {
+		throw InvalidInputException("http_write_method must be PUT or POST, got \"%s\"", result->write_method);
+	}
 
 	// HTTP Secret lookups
 	KeyValueSecretReader settings_reader(*opener, info, "http");
@@ -77,9 +128,34 @@ unique_ptr<HTTPParams> HTTPFSUtil::InitializeParameters(optional_ptr<FileOpener>
 		}
 	}
 
+	if (cache) {
+		cache->Insert(cache_key, *result);
+	}
 	return std::move(result);
 }
 
+void HTTPFSUtil::PrewarmConnections(HTTPFSParams &http_params, const string &url, const HTTPHeaders &headers,
+                                    idx_t count) {
+	// Connections can only be handed over through the pool, so there is no point in opening more than it holds
+	count = MinValue<idx_t>(count, http_params.connection_pool_size);
+	if (count == 0 || !http_params.keep_alive) {
+		return;
+	}
+	string path, proto_host_port;
+	HTTPUtil::DecomposeURL(url, path, proto_host_port);
+
+	HTTPParallelFor(http_params.io_executor, count, count, [&](idx_t) {
+		try {
+			auto client = http_params.http_util.InitializeClient(http_params, proto_host_port);
+			HeadRequestInfo head_request(url, headers, http_params);
+			client->Head(head_request);
+			// the client is destroyed here, which returns its open connection to the pool
+		} catch (std::exception &) { // NOLINT
+			// A failed pre-warm only means the file handles will have to connect themselves
+		}
+	});
+}
+
 unique_ptr<HTTPClient> HTTPClientCache::GetClient() {
 	lock_guard<mutex> lck(lock);
 	if (clients.size() == 0) {
@@ -152,11 +228,42 @@ HTTPException HTTPFileSystem::GetHTTPError(FileHandle &, const HTTPResponse &res
 }
 
 unique_ptr<HTTPResponse> HTTPFileSystem::GetRequest(FileHandle &handle, string url, HTTPHeaders header_map) {
+	return GetRequest(handle, url, std::move(header_map), nullptr);
+}
+
+unique_ptr<HTTPResponse> HTTPFileSystem::GetRequest(FileHandle &handle, const string &url, HTTPHeaders header_map,
+                                                    optional_ptr<HTTPRawBodyObserver> raw_body_observer) {
 	auto &hfh = handle.Cast<HTTPFileHandle>();
 	auto &http_util = hfh.http_params.http_util;
 
 	D_ASSERT(hfh.cached_file_handle);
 
+	auto append_to_cache = [&](const_data_ptr_t data, idx_t data_length) {
+		if (!hfh.cached_file_handle->GetCapacity()) {
+			hfh.cached_file_handle->AllocateBuffer(data_length);
+			hfh.length = data_length;
+			hfh.cached_file_handle->Write(const_char_ptr_cast(data), data_length);
+		} else {
+			auto new_capacity = hfh.cached_file_handle->GetCapacity();
+			while (new_capacity < hfh.length + data_length) {
+				new_capacity *= 2;
+			}
+			// Grow buffer when running out of space
+			if (new_capacity != hfh.cached_file_handle->GetCapacity()) {
+				hfh.cached_file_handle->GrowBuffer(new_capacity, hfh.length);
+			}
+			// We can just copy stuff
+			hfh.cached_file_handle->Write(const_char_ptr_cast(data), data_length, hfh.length);
+			hfh.length += data_length;
+		}
+	};
+
+	// The whole file is downloaded in one request, so it can be sent compressed and decoded while it is received
+	unique_ptr<HTTPContentDecoder> decoder;
+	if (hfh.http_params.compressed_downloads) {
+		header_map.Insert("Accept-Encoding", HTTPContentDecoder::ACCEPT_ENCODING);
+	}
+
 	auto http_client = hfh.GetClient();
 	GetRequestInfo get_request(
 	    url, header_map, hfh.http_params,
@@ -170,51 +277,355 @@ unique_ptr<HTTPResponse> HTTPFileSystem::GetRequest(FileHandle &handle, string u
 			    }
 			    throw HTTPException(error);
 		    }
+		    if (hfh.http_params.compressed_downloads && response.headers.HasHeader("Content-Encoding")) {
+			    decoder = HTTPContentDecoder::Create(url, response.headers.GetHeaderValue("Content-Encoding"));
+		    }
+		    if (raw_body_observer) {
+			    raw_body_observer->Start(decoder != nullptr);
+		    }
 		    return true;
 	    },
 	    [&](const_data_ptr_t data, idx_t data_length) {
-		    if (!hfh.cached_file_handle->GetCapacity()) {
-			    hfh.cached_file_handle->AllocateBuffer(data_length);
-			    hfh.length = data_length;
-			    hfh.cached_file_handle->Write(const_char_ptr_cast(data), data_length);
+		    if (raw_body_observer) {
+			    raw_body_observer->Write(data, data_length);
+		    }
+		    if (decoder) {
+			    decoder->Decode(data, data_length, append_to_cache);
 		    } else {
-			    auto new_capacity = hfh.cached_file_handle->GetCapacity();
-			    while (new_capacity < hfh.length + data_length) {
-				    new_capacity *= 2;
-			    }
-			    // Grow buffer when running out of space
-			    if (new_capacity != hfh.cached_file_handle->GetCapacity()) {
-				    hfh.cached_file_handle->GrowBuffer(new_capacity, hfh.length);
-			    }
-			    // We can just copy stuff
-			    hfh.cached_file_handle->Write(const_char_ptr_cast(data), data_length, hfh.length);
-			    hfh.length += data_length;
+			    append_to_cache(data, data_length);
 		    }
 		    return true;
 	    });
 
 	auto response = http_util.Request(get_request, http_client);
+	if (decoder && response->Success()) {
+		decoder->Finish();
+	}
 
 	hfh.StoreClient(std::move(http_client));
 	return response;
 }
 
+bool HTTPFSRangeWriter::Write(const_data_ptr_t data, idx_t data_length) {
+	if (!buffer_out) {
+		return true;
+	}
+	if (data_length + *out_offset > buffer_out_len) {
+		// As of v0.8.2-dev4424 we might end up here when very big files are served from servers
+		// that returns more data than requested via range header. This is an uncommon but legal
+		// behaviour, so we have to improve logic elsewhere to properly handle this case.
+
+		// To avoid corruption of memory, we bail out.
+		throw HTTPException("Server sent back more data than expected, `SET force_download=true` might "
+		                    "help in this case");
+	}
+	memcpy(buffer_out + *out_offset, data, data_length);
+	*out_offset += data_length;
+	return true;
+}
+
+//! State shared between the attempts of a hedged range request. An attempt that loses the race may still be running
+//! after the request has returned, so everything the attempts touch is owned by (or kept alive through) this struct.
+struct HedgedRangeState {
+	HedgedRangeState(const HTTPFSParams &params_p, const string &url_p, const HTTPHeaders &headers_p, char *buffer_out,
+	                 idx_t buffer_out_len, shared_ptr<HTTPLatencyHistogram> latency_p)
+	    : params(params_p), url(url_p), headers(headers_p), buffer_out(buffer_out), buffer_out_len(buffer_out_len),
+	      latency(std::move(latency_p)) {
+	}
+
+	HTTPFSParams params;
+	string url;
+	HTTPHeaders headers;
+
+	mutex lock;
+	std::condition_variable cv;
+	//! Destination of the request; only valid until `finished` is set. The first attempt writes into it directly (under
+	//! `lock`, until `cancelled` is set), other attempts fill a buffer of their own that is copied here if they win.
+	char *buffer_out;
+	idx_t buffer_out_len;
+	shared_ptr<HTTPLatencyHistogram> latency;
+
+	idx_t attempts_started = 0;
+	idx_t attempts_failed = 0;
+	bool first_byte_received = false;
+	bool finished = false;
+	atomic<bool> cancelled {false};
+	unique_ptr<HTTPResponse> result;
+	//! Error of the first attempt that failed, thrown if no attempt succeeds
+	ErrorData error;
+
+	bool Done() {
+		return result || attempts_failed == attempts_started;
+	}
+};
+
+static void RunHedgedRangeAttempt(shared_ptr<HedgedRangeState> state, const string &proto_host_port, bool first) {
+	unsafe_unique_array<data_t> attempt_buffer;
+	if (!first) {
+		attempt_buffer = make_unsafe_uniq_array<data_t>(state->buffer_out_len);
+	}
+	idx_t out_offset = 0;
+	bool first_byte_recorded = false;
+	auto start_time = std::chrono::steady_clock::now();
+
+	GetRequestInfo get_request(
+	    state->url, state->headers, state->params,
+	    [&](const HTTPResponse &response) {
+		    if (state->cancelled) {
+			    // the other attempt won: stop without retrying
+			    throw InterruptException();
+		    }
+		    auto status = static_cast<int>(response.status);
+		    if (!first_byte_recorded && status < 300) {
+			    auto elapsed = std::chrono::steady_clock::now() - start_time;
+			    state->latency->Record(
+			        NumericCast<idx_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+			    first_byte_recorded = true;
+			    lock_guard<mutex> guard(state->lock);
+			    state->first_byte_received = true;
+			    state->cv.notify_all();
+		    }
+		    if (status >= 400) {
+			    throw HTTPException(response, "HTTP GET error on '" + state->url + "' (HTTP " + to_string(status) + ")");
+		    }
+		    if (status < 300) {
+			    out_offset = 0;
+			    if (response.HasHeader("Content-Length") &&
+			        std::stoull(response.GetHeaderValue("Content-Length")) != state->buffer_out_len) {
+				    throw HTTPException("HTTP GET error: Content-Length from server mismatches requested range, server "
+				                        "may not support range requests.");
+			    }
+		    }
+		    return true;
+	    },
+	    [&](const_data_ptr_t data, idx_t data_length) {
+		    if (state->cancelled) {
+			    throw InterruptException();
+		    }
+		    if (out_offset + data_length > state->buffer_out_len) {
+			    throw HTTPException("Server sent back more data than expected, `SET force_download=true` might "
+			                        "help in this case");
+		    }
+		    if (first) {
+			    // nothing has won yet, so the caller is still waiting and its buffer is valid
+			    lock_guard<mutex> guard(state->lock);
+			    if (state->cancelled) {
+				    throw InterruptException();
+			    }
+			    memcpy(state->buffer_out + out_offset, data, data_length);
+		    } else {
+			    memcpy(attempt_buffer.get() + out_offset, data, data_length);
+		    }
+		    out_offset += data_length;
+		    return true;
+	    });
+
+	// Each attempt uses its own client, so the attempts run on separate connections. The request goes through the
+	// regular retry policy and logging.
+	unique_ptr<HTTPResponse> response;
+	ErrorData error;
+	try {
+		auto client = state->params.http_util.InitializeClient(state->params, proto_host_port);
+		response = state->params.http_util.Request(get_request, client);
+	} catch (std::exception &ex) {
+		error = ErrorData(ex);
+	}
+
+	lock_guard<mutex> guard(state->lock);
+	bool success = response && response->Success() && !response->HasRequestError() &&
+	               out_offset == state->buffer_out_len;
+	if (success && !state->finished && !state->result) {
+		// first complete attempt wins: the caller is still waiting, so its buffer is valid. Setting `cancelled` under
+		// the lock keeps the first attempt from writing into it any further.
+		if (!first) {
+			memcpy(state->buffer_out, attempt_buffer.get(), state->buffer_out_len);
+		}
+		state->result = std::move(response);
+		state->cancelled = true;
+	} else {
+		if (!state->error.HasError()) {
+			if (error.HasError()) {
+				state->error = std::move(error);
+			} else if (response && !response->Success()) {
+				state->error = ErrorData(HTTPException(*response, "HTTP GET error on '" + state->url + "' (HTTP " +
+				                                                      to_string(static_cast<int>(response->status)) +
+				                                                      ")"));
+			} else {
+				state->error = ErrorData(IOException("Failed to read '%s' (%s)", state->url,
+				                                     response ? response->GetError() : string("no response")));
+			}
+		}
+		state->attempts_failed++;
+	}
+	state->cv.notify_all();
+}
+
+//! Starts an attempt on the I/O executor, if it has a thread available right away. The caller waits for the attempt
+//! (possibly on a thread of the executor itself), so attempts must never be queued behind their waiters.
+static bool StartHedgedRangeAttempt(const shared_ptr<HedgedRangeState> &state, const string &proto_host_port) {
+	auto executor = state->params.io_executor;
+	if (!executor) {
+		return false;
+	}
+	auto first = state->attempts_started++ == 0;
+	auto cancel = [state]() {
+		lock_guard<mutex> guard(state->lock);
+		if (!state->error.HasError()) {
+			state->error =
+			    ErrorData(IOException("Failed to read '%s': the HTTP I/O executor was shut down", state->url));
+		}
+		state->attempts_failed++;
+		state->cv.notify_all();
+	};
+	if (!executor->TrySchedule(
+	        [state, proto_host_port, first]() { RunHedgedRangeAttempt(state, proto_host_port, first); }, cancel)) {
+		state->attempts_started--;
+		return false;
+	}
+	return true;
+}
+
+//! Sends the range request and, if the first byte has not arrived after `hedge_delay`, sends a duplicate on another
+//! connection. Returns the response of whichever attempt completed first, and throws the error of the first attempt
+//! if all of them failed. Returns nullptr if no attempt could be started, in which case the request is not hedged.
+static unique_ptr<HTTPResponse> HedgedRangeRequest(HTTPFSParams &params, const string &url, const HTTPHeaders &headers,
+                                                   char *buffer_out, idx_t buffer_out_len,
+                                                   shared_ptr<HTTPLatencyHistogram> latency,
+                                                   std::chrono::microseconds hedge_delay) {
+	string path, proto_host_port;
+	HTTPUtil::DecomposeURL(url, path, proto_host_port);
+	auto state =
+	    make_shared_ptr<HedgedRangeState>(params, url, headers, buffer_out, buffer_out_len, std::move(latency));
+
+	unique_lock<mutex> lck(state->lock);
+	if (!StartHedgedRangeAttempt(state, proto_host_port)) {
+		return nullptr;
+	}
+	state->cv.wait_for(lck, hedge_delay, [&]() { return state->first_byte_received || state->Done(); });
+	if (!state->first_byte_received && !state->Done()) {
+		// if the executor is busy the request is simply not hedged
+		if (StartHedgedRangeAttempt(state, proto_host_port) && params.state) {
+			params.state->hedged_request_count++;
+		}
+	}
+	state->cv.wait(lck, [&]() { return state->Done(); });
+	// from here on the attempts that are still running must not touch the caller's buffer anymore
+	state->finished = true;
+	state->cancelled = true;
+	if (!state->result) {
+		state->error.Throw();
+	}
+	return std::move(state->result);
+}
+
+//! A server answers a range request that extends beyond the end of the file with the part up to the end of the file,
+//! which is fine for callers that do not know the file size yet (e.g. the probe read when opening a file)
+static bool IsRangeClippedAtEnd(const HTTPResponse &response, idx_t file_offset, idx_t content_length) {
+	if (response.status != HTTPStatusCode::PartialContent_206 || !response.HasHeader("Content-Range")) {
+		return false;
+	}
+	// Content-Range: bytes <start>-<end>/<total>
+	auto content_range = response.GetHeaderValue("Content-Range");
+	auto dash = content_range.find('-');
+	auto slash = content_range.find('/');
+	if (dash == string::npos || slash == string::npos || slash < dash) {
+		return false;
+	}
+	auto space = content_range.find(' ');
+	auto start_str = content_range.substr(space == string::npos ? 0 : space + 1, dash - (space + 1));
+	auto end_str = content_range.substr(dash + 1, slash - dash - 1);
+	auto total_str = content_range.substr(slash + 1);
+	idx_t start, end, total;
+	if (!TryCast::Operation<string_t, idx_t>(string_t(start_str), start, true) ||
+	    !TryCast::Operation<string_t, idx_t>(string_t(end_str), end, true) ||
+	    !TryCast::Operation<string_t, idx_t>(string_t(total_str), total, true)) {
+		return false;
+	}
+	return start == file_offset && end + 1 == total && end + 1 - start == content_length;
+}
+
+shared_ptr<HTTPLatencyHistogram> HTTPFileSystem::GetHostLatency(const string &proto_host_port) {
+	lock_guard<mutex> guard(host_latency_lock);
+	auto &entry = host_latencies[proto_host_port];
+	if (!entry) {
+		entry = make_shared_ptr<HTTPLatencyHistogram>();
+	}
+	return entry;
+}
+
 unique_ptr<HTTPResponse> HTTPFileSystem::GetRangeRequest(FileHandle &handle, string url, HTTPHeaders header_map,
                                                          idx_t file_offset, char *buffer_out, idx_t buffer_out_len) {
 	auto &hfh = handle.Cast<HTTPFileHandle>();
-	auto &http_util = hfh.http_params.http_util;
+	return GetRangeRequest(hfh, hfh.http_params, nullptr, url, std::move(header_map), file_offset, buffer_out,
+	                       buffer_out_len);
+}
+
+unique_ptr<HTTPResponse> HTTPFileSystem::GetRangeRequest(HTTPFileHandle &hfh, HTTPFSParams &params,
+                                                         optional_ptr<HTTPClientCache> client_cache, const string &url,
+                                                         HTTPHeaders header_map, idx_t file_offset, char *buffer_out,
+                                                         idx_t buffer_out_len) {
+	auto &http_util = params.http_util;
 
 	// send the Range header to read only subset of file
 	string range_expr = "bytes=" + to_string(file_offset) + "-" + to_string(file_offset + buffer_out_len - 1);
 	header_map.Insert("Range", range_expr);
 
-	auto http_client = hfh.GetClient();
+	string url_path, proto_host_port;
+	HTTPUtil::DecomposeURL(url, url_path, proto_host_port);
+	auto latency_ptr = GetHostLatency(proto_host_port);
+	auto &latency = *latency_ptr;
+
+	auto hedge_percentile = params.hedge_percentile;
+	if (hedge_percentile > 0 && buffer_out && !hfh.probing_file_info && latency.Count() >= MIN_HEDGE_SAMPLES) {
+		auto hedge_delay = MaxValue<idx_t>(latency.Percentile(hedge_percentile), MIN_HEDGE_DELAY_MICROS);
+		auto response = HedgedRangeRequest(params, url, header_map, buffer_out, buffer_out_len, latency_ptr,
+		                                   std::chrono::microseconds(hedge_delay));
+		if (response) {
+			return response;
+		}
+		// No thread of the I/O executor was available to run the attempts: send the request without hedging
+	}
+
+	unique_ptr<HTTPClient> http_client;
+	if (client_cache) {
+		http_client = client_cache->GetClient();
+		if (!http_client) {
+			http_client = http_util.InitializeClient(params, proto_host_port);
+		}
+	} else {
+		http_client = hfh.GetClient();
+	}
 
 	idx_t out_offset = 0;
+	bool first_byte_recorded = false;
+	bool discard_body = false;
+	auto start_time = std::chrono::steady_clock::now();
+
+	HTTPFSRangeWriter range_writer(data_ptr_cast(buffer_out), buffer_out_len, out_offset);
+	std::function<bool(const_data_ptr_t data, idx_t data_length)> content_handler = range_writer;
+	if (hfh.probing_file_info) {
+		content_handler = [&](const_data_ptr_t data, idx_t data_length) {
+			return discard_body || range_writer.Write(data, data_length);
+		};
+	}
 
 	GetRequestInfo get_request(
-	    url, header_map, hfh.http_params,
+	    url, header_map, params,
 	    [&](const HTTPResponse &response) {
+		    if (!first_byte_recorded && static_cast<int>(response.status) < 300) {
+			    auto elapsed = std::chrono::steady_clock::now() - start_time;
+			    latency.Record(
+			        NumericCast<idx_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+			    first_byte_recorded = true;
+		    }
+		    if (hfh.probing_file_info &&
+		        (response.status == HTTPStatusCode::NotFound_404 ||
+		         (static_cast<int>(response.status) < 300 && response.status != HTTPStatusCode::PartialContent_206))) {
+			    // Thrown errors are retried: hand the response back so that a missing file, or a server that ignores
+			    // the Range header (and answers with the whole file), costs a single request
+			    discard_body = true;
+			    return true;
+		    }
 		    if (static_cast<int>(response.status) >= 400) {
 			    string error =
 			        "HTTP GET error on '" + url + "' (HTTP " + to_string(static_cast<int>(response.status)) + ")";
@@ -228,7 +639,8 @@ unique_ptr<HTTPResponse> HTTPFileSystem::GetRangeRequest(FileHandle &handle, str
 			    out_offset = 0;
 			    if (response.HasHeader("Content-Length")) {
 				    auto content_length = stoll(response.GetHeaderValue("Content-Length"));
-				    if ((idx_t)content_length != buffer_out_len) {
+				    if ((idx_t)content_length != buffer_out_len &&
+				        !IsRangeClippedAtEnd(response, file_offset, NumericCast<idx_t>(content_length))) {
 					    throw HTTPException("HTTP GET error: Content-Length from server mismatches requested "
 					                        "range, server may not support range requests.");
 				    }
@@ -236,26 +648,15 @@ unique_ptr<HTTPResponse> HTTPFileSystem::GetRangeRequest(FileHandle &handle, str
 		    }
 		    return true;
 	    },
-	    [&](const_data_ptr_t data, idx_t data_length) {
-		    if (buffer_out != nullptr) {
-			    if (data_length + out_offset > buffer_out_len) {
-				    // As of v0.8.2-dev4424 we might end up here when very big files are served from servers
-				    // that returns more data than requested via range header. This is an uncommon but legal
-				    // behaviour, so we have to improve logic elsewhere to properly handle this case.
-
-				    // To avoid corruption of memory, we bail out.
-				    throw HTTPException("Server sent back more data than expected, `SET force_download=true` might "
-				                        "help in this case");
-			    }
-			    memcpy(buffer_out + out_offset, data, data_length);
-			    out_offset += data_length;
-		    }
-		    return true;
-	    });
+	    std::move(content_handler));
 
 	auto response = http_util.Request(get_request, http_client);
 
-	hfh.StoreClient(std::move(http_client));
+	if (client_cache) {
+		client_cache->StoreClient(std::move(http_client));
+	} else {
+		hfh.StoreClient(std::move(http_client));
+	}
 	return response;
 }
 
@@ -349,6 +750,417 @@ unique_ptr<FileHandle> HTTPFileSystem::OpenFileExtended(const OpenFileInfo &file
 	return std::move(handle);
 }
 
+//! Streaming parser for `multipart/byteranges` responses: copies the body of every part straight into the requested
+//! ranges it intersects with. Ranges must be sorted by offset and must not overlap.
+class MultipartByteRangeParser {
+public:
+	MultipartByteRangeParser(const string &boundary, vector<HTTPFileRange> &ranges_p)
+	    : delimiter("--" + boundary), ranges(ranges_p), received(ranges_p.size(), 0) {
+	}
+
+	void Feed(const_data_ptr_t data, idx_t data_length) {
+		idx_t pos = 0;
+		while (pos < data_length) {
+			if (state == ParserState::BODY) {
+				auto to_copy = MinValue<idx_t>(part_remaining, data_length - pos);
+				Deliver(part_offset, data + pos, to_copy);
+				part_offset += to_copy;
+				part_remaining -= to_copy;
+				pos += to_copy;
+				if (part_remaining == 0) {
+					state = ParserState::DELIMITER;
+				}
+				continue;
+			}
+			if (state == ParserState::EPILOGUE) {
+				return;
+			}
+			auto c = static_cast<char>(data[pos++]);
+			if (c != '\n') {
+				if (line.size() >= MAX_LINE_LENGTH) {
+					throw IOException("Failed to parse multipart/byteranges response: line too long");
+				}
+				line += c;
+				continue;
+			}
+			if (!line.empty() && line.back() == '\r') {
+				line.pop_back();
+			}
+			ProcessLine();
+			line.clear();
+		}
+	}
+
+	//! Copies bytes of a part (starting at file offset `offset`) into the ranges they belong to
+	void Deliver(idx_t offset, const_data_ptr_t data, idx_t data_length) {
+		auto end = offset + data_length;
+		// first range that ends after `offset`
+		auto it = std::lower_bound(ranges.begin(), ranges.end(), offset,
+		                           [](const HTTPFileRange &range, idx_t off) { return range.offset + range.length <= off; });
+		for (; it != ranges.end() && it->offset < end; it++) {
+			auto copy_start = MaxValue<idx_t>(it->offset, offset);
+			auto copy_end = MinValue<idx_t>(it->offset + it->length, end);
+			memcpy(it->buffer + (copy_start - it->offset), data + (copy_start - offset), copy_end - copy_start);
+			received[NumericCast<idx_t>(it - ranges.begin())] += copy_end - copy_start;
+		}
+	}
+
+	//! Whether the multipart response was complete and covered all requested ranges
+	bool Complete() const {
+		return state == ParserState::EPILOGUE && ReceivedAll();
+	}
+
+	bool ReceivedAll() const {
+		for (idx_t i = 0; i < ranges.size(); i++) {
+			if (received[i] < ranges[i].length) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static bool TryParseContentRange(const string &content_range, idx_t &start, idx_t &end) {
+		// bytes <start>-<end>/<total>
+		if (!StringUtil::StartsWith(content_range, "bytes ")) {
+			return false;
+		}
+		auto dash = content_range.find('-');
+		auto slash = content_range.find('/');
+		if (dash == string::npos || slash == string::npos || slash < dash) {
+			return false;
+		}
+		auto start_str = content_range.substr(6, dash - 6);
+		auto end_str = content_range.substr(dash + 1, slash - dash - 1);
+		return TryCast::Operation<string_t, idx_t>(string_t(start_str), start, true) &&
+		       TryCast::Operation<string_t, idx_t>(string_t(end_str), end, true) && end >= start;
+	}
+
+private:
+	enum class ParserState : uint8_t { DELIMITER, HEADERS, BODY, EPILOGUE };
+	static constexpr idx_t MAX_LINE_LENGTH = 8192;
+
+	void ProcessLine() {
+		if (state == ParserState::DELIMITER) {
+			// the preamble and the line break that ends a body part are skipped
+			if (line == delimiter) {
+				state = ParserState::HEADERS;
+				part_has_range = false;
+			} else if (line == delimiter + "--") {
+				state = ParserState::EPILOGUE;
+			}
+			return;
+		}
+		D_ASSERT(state == ParserState::HEADERS);
+		if (line.empty()) {
+			if (!part_has_range) {
+				throw IOException("Failed to parse multipart/byteranges response: part without Content-Range");
+			}
+			state = part_remaining > 0 ? ParserState::BODY : ParserState::DELIMITER;
+			return;
+		}
+		auto colon = line.find(':');
+		if (colon == string::npos || !StringUtil::CIEquals(line.substr(0, colon), "Content-Range")) {
+			return;
+		}
+		auto value = line.substr(colon + 1);
+		StringUtil::Trim(value);
+		idx_t start, end;
+		if (!TryParseContentRange(value, start, end)) {
+			throw IOException("Failed to parse multipart/byteranges response: invalid Content-Range \"%s\"", value);
+		}
+		part_has_range = true;
+		part_offset = start;
+		part_remaining = end - start + 1;
+	}
+
+	string delimiter;
+	vector<HTTPFileRange> &ranges;
+	vector<idx_t> received;
+
+	ParserState state = ParserState::DELIMITER;
+	string line;
+	bool part_has_range = false;
+	idx_t part_offset = 0;
+	idx_t part_remaining = 0;
+};
+
+//! Returns the boundary of a `multipart/byteranges` content type, or an empty string for any other content type
+static string GetMultipartBoundary(const string &content_type) {
+	if (!StringUtil::StartsWith(StringUtil::Lower(content_type), "multipart/byteranges")) {
+		return string();
+	}
+	for (auto &param : StringUtil::Split(content_type, ';')) {
+		StringUtil::Trim(param);
+		if (StringUtil::StartsWith(StringUtil::Lower(param), "boundary=")) {
+			auto boundary = param.substr(9);
+			if (boundary.size() >= 2 && boundary.front() == '"' && boundary.back() == '"') {
+				boundary = boundary.substr(1, boundary.size() - 2);
+			}
+			return boundary;
+		}
+	}
+	return string();
+}
+
+bool HTTPFileSystem::GetMultiRangeRequest(FileHandle &handle, const string &url, HTTPHeaders header_map,
+                                          vector<HTTPFileRange> &ranges) {
+	auto &hfh = handle.Cast<HTTPFileHandle>();
+	D_ASSERT(!ranges.empty());
+
+	string range_expr = "bytes=";
+	for (idx_t i = 0; i < ranges.size(); i++) {
+		if (i > 0) {
+			range_expr += ",";
+		}
+		range_expr += to_string(ranges[i].offset) + "-" + to_string(ranges[i].offset + ranges[i].length - 1);
+	}
+	header_map.Insert("Range", range_expr);
+
+	unique_ptr<MultipartByteRangeParser> parser;
+	bool single_part = false;
+	idx_t single_part_offset = 0;
+
+	GetRequestInfo get_request(
+	    url, header_map, hfh.http_params,
+	    [&](const HTTPResponse &response) {
+		    auto status = static_cast<int>(response.status);
+		    if (status >= 300 && status < 400) {
+			    return true;
+		    }
+		    if (response.status != HTTPStatusCode::PartialContent_206) {
+			    // 200 means the server ignores the Range header and sends the whole file: not worth downloading
+			    if (response.status == HTTPStatusCode::OK_200) {
+				    hfh.multi_range_support = MultiRangeSupport::UNSUPPORTED;
+			    }
+			    return false;
+		    }
+		    auto boundary = GetMultipartBoundary(response.GetHeaderValue("Content-Type"));
+		    parser = make_uniq<MultipartByteRangeParser>(boundary, ranges);
+		    if (boundary.empty()) {
+			    // the server merged the ranges into a single one
+			    idx_t end;
+			    if (!response.HasHeader("Content-Range") ||
+			        !MultipartByteRangeParser::TryParseContentRange(response.GetHeaderValue("Content-Range"),
+			                                                        single_part_offset, end)) {
+				    return false;
+			    }
+			    single_part = true;
+		    }
+		    return true;
+	    },
+	    [&](const_data_ptr_t data, idx_t data_length) {
+		    if (!parser) {
+			    return false;
+		    }
+		    if (single_part) {
+			    parser->Deliver(single_part_offset, data, data_length);
+			    single_part_offset += data_length;
+		    } else {
+			    parser->Feed(data, data_length);
+		    }
+		    return true;
+	    });
+
+	// The request is not retried: on any failure the caller falls back to (retried) single range requests
+	auto http_client = hfh.GetClient();
+	unique_ptr<HTTPResponse> response;
+	try {
+		response = http_client->Get(get_request);
+	} catch (std::exception &) { // NOLINT
+		return false;
+	}
+	hfh.StoreClient(std::move(http_client));
+	if (!parser || !response || response->HasRequestError() ||
+	    response->status != HTTPStatusCode::PartialContent_206) {
+		return false;
+	}
+	bool complete = single_part ? parser->ReceivedAll() : parser->Complete();
+	if (complete) {
+		hfh.multi_range_support = MultiRangeSupport::SUPPORTED;
+	}
+	return complete;
+}
+
+void HTTPFileSystem::ReadRanges(FileHandle &handle, vector<HTTPFileRange> &ranges) {
+	auto &hfh = handle.Cast<HTTPFileHandle>();
+	if (ranges.empty()) {
+		return;
+	}
+	if (hfh.cached_file_handle) {
+		for (auto &range : ranges) {
+			Read(handle, range.buffer, NumericCast<int64_t>(range.length), range.offset);
+		}
+		return;
+	}
+
+	vector<HTTPFileRange> pending;
+	auto max_ranges = hfh.http_params.max_ranges_per_request;
+	if (ranges.size() > 1 && max_ranges > 1 && SupportsMultiRangeRequests(handle) &&
+	    hfh.multi_range_support != MultiRangeSupport::UNSUPPORTED) {
+		auto sorted = ranges;
+		std::sort(sorted.begin(), sorted.end(),
+		          [](const HTTPFileRange &a, const HTTPFileRange &b) { return a.offset < b.offset; });
+		bool overlapping = false;
+		for (idx_t i = 1; i < sorted.size(); i++) {
+			if (sorted[i - 1].offset + sorted[i - 1].length > sorted[i].offset) {
+				overlapping = true;
+				break;
+			}
+		}
+		if (!overlapping) {
+			for (idx_t start = 0; start < sorted.size(); start += max_ranges) {
+				auto end = MinValue<idx_t>(start + max_ranges, sorted.size());
+				vector<HTTPFileRange> batch(sorted.begin() + NumericCast<int64_t>(start),
+				                            sorted.begin() + NumericCast<int64_t>(end));
+				if (hfh.multi_range_support == MultiRangeSupport::UNSUPPORTED ||
+				    !GetMultiRangeRequest(handle, hfh.path, {}, batch)) {
+					pending.insert(pending.end(), batch.begin(), batch.end());
+				}
+			}
+		} else {
+			pending = std::move(sorted);
+		}
+	} else {
+		pending = ranges;
+	}
+
+	HTTPParallelFor(hfh.http_params.io_executor, pending.size(), hfh.http_params.read_ranges_concurrency, [&](idx_t i) {
+		auto &range = pending[i];
+		GetRangeRequest(hfh, hfh.path, {}, range.offset, char_ptr_cast(range.buffer), range.length);
+	});
+	for (auto &range : ranges) {
+		DUCKDB_LOG_FILE_SYSTEM_READ(handle, range.length, range.offset);
+	}
+}
+
+void HTTPFileSystem::ReadV(FileHandle &handle, const vector<HTTPFileRange> &ranges) {
+	auto &hfh = handle.Cast<HTTPFileHandle>();
+	D_ASSERT(hfh.http_params.state);
+
+	// Serve what we can from memory
+	vector<HTTPFileRange> to_fetch;
+	for (auto &range : ranges) {
+		if (range.length == 0) {
+			continue;
+		}
+		if (hfh.cached_file_handle) {
+			if (!hfh.cached_file_handle->Initialized()) {
+				throw InternalException("Cached file not initialized properly");
+			}
+			memcpy(range.buffer, hfh.cached_file_handle->GetData() + range.offset, range.length);
+			continue;
+		}
+		if (hfh.TryReadFromTail(range.buffer, range.length, range.offset)) {
+			continue;
+		}
+		to_fetch.push_back(range);
+	}
+	if (to_fetch.empty()) {
+		return;
+	}
+
+	// Coalesce ranges that are close to each other into a single fetch: one request that reads a few unneeded bytes
+	// is much cheaper than an extra round trip
+	std::sort(to_fetch.begin(), to_fetch.end(),
+	          [](const HTTPFileRange &a, const HTTPFileRange &b) { return a.offset < b.offset; });
+	struct CoalescedRead {
+		idx_t offset;
+		idx_t length;
+		//! The requested ranges that are part of this read
+		idx_t first_range;
+		idx_t range_count;
+		unsafe_unique_array<data_t> buffer;
+	};
+	vector<CoalescedRead> reads;
+	auto max_gap = hfh.http_params.read_coalesce_gap;
+	for (idx_t i = 0; i < to_fetch.size(); i++) {
+		auto &range = to_fetch[i];
+		if (!reads.empty()) {
+			auto &last = reads.back();
+			auto last_end = last.offset + last.length;
+			auto new_end = MaxValue<idx_t>(last_end, range.offset + range.length);
+			if (range.offset <= last_end + max_gap && new_end - last.offset <= MAX_COALESCED_READ_SIZE) {
+				last.length = new_end - last.offset;
+				last.range_count++;
+				continue;
+			}
+		}
+		reads.push_back(CoalescedRead {range.offset, range.length, i, 1, nullptr});
+	}
+
+	// Reads that consist of a single range go straight into its buffer, others into a temporary buffer
+	vector<HTTPFileRange> fetches;
+	for (auto &read : reads) {
+		data_ptr_t target;
+		if (read.range_count == 1) {
+			target = to_fetch[read.first_range].buffer;
+		} else {
+			read.buffer = make_unsafe_uniq_array<data_t>(read.length);
+			target = read.buffer.get();
+		}
+		fetches.push_back(HTTPFileRange {read.offset, read.length, target});
+	}
+	ReadRanges(handle, fetches);
+
+	for (auto &read : reads) {
+		if (!read.buffer) {
+			continue;
+		}
+		for (idx_t i = read.first_range; i < read.first_range + read.range_count; i++) {
+			auto &range = to_fetch[i];
+			memcpy(range.buffer, read.buffer.get() + (range.offset - read.offset), range.length);
+		}
+	}
+}
+
+void HTTPFileSystem::ReadAsync(FileHandle &handle, void *buffer, idx_t nr_bytes, idx_t location,
+                               HTTPCompletionQueue &queue, idx_t tag) {
+	auto &hfh = handle.Cast<HTTPFileHandle>();
+	D_ASSERT(hfh.http_params.state);
+
+	queue.Start();
+	auto read = [this, &hfh, buffer, nr_bytes, location, &queue, tag]() {
+		ErrorData error;
+		try {
+			GetRangeRequest(hfh, hfh.path, {}, location, (char *)buffer, nr_bytes);
+			DUCKDB_LOG_FILE_SYSTEM_READ(hfh, nr_bytes, location);
+		} catch (std::exception &ex) {
+			error = ErrorData(ex);
+		}
+		queue.Complete(tag, std::move(error));
+	};
+
+	// Serve what we can from memory
+	if (nr_bytes == 0) {
+		queue.Complete(tag);
+		return;
+	}
+	if (hfh.cached_file_handle) {
+		ErrorData error;
+		if (!hfh.cached_file_handle->Initialized()) {
+			error = ErrorData(ExceptionType::INTERNAL, "Cached file not initialized properly");
+		} else {
+			memcpy(buffer, hfh.cached_file_handle->GetData() + location, nr_bytes);
+		}
+		queue.Complete(tag, std::move(error));
+		return;
+	}
+	if (hfh.TryReadFromTail(buffer, nr_bytes, location)) {
+		queue.Complete(tag);
+		return;
+	}
+
+	if (!hfh.http_params.io_executor) {
+		read();
+		return;
+	}
+	auto cancel = [&hfh, &queue, tag]() {
+		queue.Complete(tag, ErrorData(IOException("Read of '%s' was cancelled: the HTTP I/O executor was shut down",
+		                                          hfh.path)));
+	};
+	hfh.http_params.io_executor->Schedule(read, cancel);
+}
+
 // Buffered read from http file.
 // Note that buffering is disabled when FileFlags::FILE_FLAGS_DIRECT_IO is set
 void HTTPFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
@@ -365,6 +1177,17 @@ void HTTPFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, id
 		return;
 	}
 
+	if (hfh.TryReadFromTail(buffer, nr_bytes, location)) {
+		DUCKDB_LOG_FILE_SYSTEM_READ(handle, nr_bytes, location);
+		if (hfh.flags.RequireParallelAccess()) {
+			std::lock_guard<std::mutex> lck(hfh.mu);
+			hfh.file_offset = location + nr_bytes;
+			return;
+		}
+		hfh.file_offset = location + nr_bytes;
+		return;
+	}
+
 	idx_t to_read = nr_bytes;
 	idx_t buffer_offset = 0;
 
@@ -444,7 +1267,17 @@ int64_t HTTPFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes)
 }
 
 void HTTPFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
-	throw NotImplementedException("Writing to HTTP files not implemented");
+	auto &hfh = handle.Cast<HTTPFileHandle>();
+	if (!hfh.flags.OpenForWriting()) {
+		throw InternalException("Write called on file not opened in write mode");
+	}
+	// The file is streamed to the server as it is written, so it can only be written front to back
+	if (location != hfh.file_offset) {
+		throw NotImplementedException("Non-sequential write not supported for HTTP files: \"%s\"", hfh.path);
+	}
+	hfh.GetUpload().Write(const_data_ptr_cast(buffer), UnsafeNumericCast<idx_t>(nr_bytes));
+	hfh.file_offset += nr_bytes;
+	DUCKDB_LOG_FILE_SYSTEM_WRITE(handle, nr_bytes, location);
 }
 
 int64_t HTTPFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes) {
@@ -454,7 +1287,14 @@ int64_t HTTPFileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes
 }
 
 void HTTPFileSystem::FileSync(FileHandle &handle) {
-	throw NotImplementedException("FileSync for HTTP files not implemented");
+	auto &hfh = handle.Cast<HTTPFileHandle>();
+	if (!hfh.flags.OpenForWriting()) {
+		throw NotImplementedException("FileSync for HTTP files not implemented");
+	}
+	// The file only becomes visible on the server once the upload completes: later writes fail
+	if (!hfh.upload_finished) {
+		hfh.FinishUpload();
+	}
 }
 
 int64_t HTTPFileSystem::GetFileSize(FileHandle &handle) {
@@ -594,15 +1434,65 @@ optional_idx TryParseContentLength(const HTTPHeaders &headers) {
 	}
 }
 
+bool HTTPFileHandle::TryProbeFileInfo() {
+	auto probe_size = MinValue<idx_t>(http_params.probe_read_size, READ_BUFFER_LEN);
+	if (!read_buffer) {
+		read_buffer = duckdb::unique_ptr<data_t[]>(new data_t[READ_BUFFER_LEN]);
+	}
+	auto &hfs = file_system.Cast<HTTPFileSystem>();
+	unique_ptr<HTTPResponse> res;
+	probing_file_info = true;
+	try {
+		res = hfs.GetRangeRequest(*this, path, {}, 0, char_ptr_cast(read_buffer.get()), probe_size);
+	} catch (std::exception &) { // NOLINT
+		// e.g. an empty file (416) or a server that does not support range requests: use a HEAD request instead
+		probing_file_info = false;
+		return false;
+	}
+	probing_file_info = false;
+	if (res->status == HTTPStatusCode::NotFound_404) {
+		// The file does not exist: a HEAD request would only tell us the same
+		throw HTTPException(*res, "Unable to connect to URL \"%s\": %d (%s).", res->url, static_cast<int>(res->status),
+		                    res->GetError());
+	}
+	if (res->status != HTTPStatusCode::PartialContent_206) {
+		return false;
+	}
+	auto content_size = TryParseContentRange(res->headers);
+	if (!content_size.IsValid()) {
+		return false;
+	}
+	length = content_size.GetIndex();
+	if (res->headers.HasHeader("Last-Modified")) {
+		HTTPFileSystem::TryParseLastModifiedTime(res->headers.GetHeaderValue("Last-Modified"), last_modified);
+	}
+	if (res->headers.HasHeader("ETag")) {
+		etag = res->headers.GetHeaderValue("ETag");
+	}
+	// The bytes that came with the probe become the contents of the read buffer
+	buffer_start = 0;
+	buffer_end = MinValue<idx_t>(probe_size, length);
+	buffer_idx = 0;
+	buffer_available = buffer_end;
+	initialized = true;
+	return true;
+}
+
 void HTTPFileHandle::LoadFileInfo() {
 	if (initialized || force_full_download) {
 		// already initialized or we specifically do not want to perform a head request and just run a direct download
 		return;
 	}
+	if (http_params.probe_read_size > 0 && flags.OpenForReading() && !flags.OpenForWriting() &&
+	    TryProbeFileInfo()) {
+		return;
+	}
 	auto &hfs = file_system.Cast<HTTPFileSystem>();
 	auto res = hfs.HeadRequest(*this, path, {});
 	if (res->status != HTTPStatusCode::OK_200) {
-		if (flags.OpenForWriting() && res->status == HTTPStatusCode::NotFound_404) {
+		// Upload-only endpoints may not allow HEAD requests at all
+		if (flags.OpenForWriting() && (res->status == HTTPStatusCode::NotFound_404 ||
+		                               res->status == HTTPStatusCode::MethodNotAllowed_405)) {
 			if (!flags.CreateFileIfNotExists() && !flags.OverwriteExistingFile()) {
 				throw IOException("Unable to open URL \"" + path +
 				                  "\" for writing: file does not exist and CREATE flag is not set");
@@ -693,7 +1583,9 @@ void HTTPFileHandle::Initialize(optional_ptr<FileOpener> opener) {
 		}
 
 		// Initialize the read buffer now that we know the file exists
-		read_buffer = duckdb::unique_ptr<data_t[]>(new data_t[READ_BUFFER_LEN]);
+		if (!read_buffer) {
+			read_buffer = duckdb::unique_ptr<data_t[]>(new data_t[READ_BUFFER_LEN]);
+		}
 	}
 
 	// If we're writing to a file, we might as well remove it from the cache
@@ -702,6 +1594,59 @@ void HTTPFileHandle::Initialize(optional_ptr<FileOpener> opener) {
 	}
 }
 
+idx_t HTTPFileHandle::GetTailPrefetchSize() {
+	if (!flags.OpenForReading() || cached_file_handle || !StringUtil::EndsWith(StringUtil::Lower(path), ".parquet")) {
+		return 0;
+	}
+	if (buffer_start == 0 && buffer_end == length) {
+		// the whole file already came with the probe read
+		return 0;
+	}
+	return MinValue<idx_t>(http_params.tail_prefetch_size, length);
+}
+
+void HTTPFileHandle::PrefetchTail(idx_t tail_size) {
+	// Parquet readers start with the 8 byte footer and then read the metadata right before it: fetching the tail of
+	// the file in one go saves these round trips
+	auto &hfs = file_system.Cast<HTTPFileSystem>();
+	auto buffer = make_unsafe_uniq_array<data_t>(tail_size);
+	try {
+		hfs.GetRangeRequest(*this, path, {}, length - tail_size, char_ptr_cast(buffer.get()), tail_size);
+	} catch (std::exception &ex) {
+		// Not fatal: the read is sent to the server on its own, which reports the error if there is one
+		if (logger) {
+			ErrorData error(ex);
+			DUCKDB_LOG_WARN(logger, "Failed to prefetch the last %llu bytes of '%s': %s", tail_size, path,
+			                error.RawMessage());
+		}
+		return;
+	}
+	tail_buffer = std::move(buffer);
+	tail_start = length - tail_size;
+	tail_length = tail_size;
+}
+
+bool HTTPFileHandle::TryReadFromTail(void *buffer, idx_t nr_bytes, idx_t location) {
+	if (!tail_fetched) {
+		// The tail is fetched by the first read that falls into it (for Parquet files the footer), so that opens that
+		// do not read it, such as FileExists or scans whose metadata is cached, do not send a request for it
+		auto tail_size = GetTailPrefetchSize();
+		if (tail_size == 0 || location < length - tail_size) {
+			return false;
+		}
+		lock_guard<mutex> guard(tail_lock);
+		if (!tail_fetched) {
+			PrefetchTail(tail_size);
+			tail_fetched = true;
+		}
+	}
+	if (!tail_buffer || location < tail_start || location + nr_bytes > tail_start + tail_length) {
+		return false;
+	}
+	memcpy(buffer, tail_buffer.get() + (location - tail_start), nr_bytes);
+	return true;
+}
+
 unique_ptr<HTTPClient> HTTPFileHandle::GetClient() {
 	// Try to fetch a cached client
 	auto cached_client = client_cache.GetClient();
@@ -728,8 +1673,54 @@ HTTPFileHandle::~HTTPFileHandle() {
 	DUCKDB_LOG_FILE_SYSTEM_CLOSE((*this));
 };
 
+void HTTPFileHandle::Close() {
+	if (flags.OpenForWriting() && !upload_finished) {
+		FinishUpload();
+	}
+}
+
+HTTPStreamingUpload &HTTPFileHandle::GetUpload() {
+	if (upload_finished) {
+		throw IOException("Cannot write to \"%s\": the file has already been uploaded", path);
+	}
+	if (!upload) {
+		if (http_params.http_util.GetName() != "HTTPFS") {
+			throw NotImplementedException("Writing to HTTP files is not supported by the %s client",
+			                              http_params.http_util.GetName());
+		}
+		upload = make_uniq<HTTPStreamingUpload>(static_cast<HTTPFSUtil &>(http_params.http_util), http_params, path,
+		                                        HTTPHeaders());
+	}
+	return *upload;
+}
+
+void HTTPFileHandle::FinishUpload() {
+	auto &current_upload = GetUpload();
+	// A failed upload is not retried: the data that was written is gone
+	upload_finished = true;
+	current_upload.Finish();
+}
+
 string HTTPFSUtil::GetName() const {
 	return "HTTPFS";
 }
 
+shared_ptr<HTTPGlobalStats> HTTPFSUtil::GetGlobalStats() {
+	lock_guard<mutex> guard(connection_pool_lock);
+	if (!global_stats) {
+		global_stats = make_shared_ptr<HTTPGlobalStats>();
+	}
+	return global_stats;
+}
+
+HTTPIOExecutor &HTTPFSUtil::GetIOExecutor(idx_t max_threads) {
+	lock_guard<mutex> guard(connection_pool_lock);
+	if (!io_executor) {
+		io_executor = make_shared_ptr<HTTPIOExecutor>(max_threads);
+	} else {
+		io_executor->SetMaxThreads(max_threads);
+	}
+	return *io_executor;
+}
+
 } // namespace duckdb
@@ -1,88 +1,494 @@
 #include "httpfs_client.hpp"
 #include "http_state.hpp"
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/operator/cast_operators.hpp"
 
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 #include "httplib.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+
 namespace duckdb {
 
-class HTTPFSClient : public HTTPClient {
+//! Idle keep-alive connections, keyed by host and client configuration, that can be picked up by any new client
+class HTTPFSConnectionPool {
 public:
-	HTTPFSClient(HTTPFSParams &http_params, const string &proto_host_port) {
-		client = make_uniq<duckdb_httplib_openssl::Client>(proto_host_port);
-		client->set_follow_location(http_params.follow_location);
-		client->set_keep_alive(http_params.keep_alive);
-		if (!http_params.ca_cert_file.empty()) {
-			client->set_ca_cert_path(http_params.ca_cert_file.c_str());
+	unique_ptr<duckdb_httplib_openssl::Client> GetConnection(const string &key) {
+		lock_guard<mutex> guard(lock);
+		auto entry = idle_connections.find(key);
+		if (entry == idle_connections.end() || entry->second.empty()) {
+			return nullptr;
 		}
-		client->enable_server_certificate_verification(http_params.enable_server_cert_verification);
-		client->set_write_timeout(http_params.timeout, http_params.timeout_usec);
-		client->set_read_timeout(http_params.timeout, http_params.timeout_usec);
-		client->set_connection_timeout(http_params.timeout, http_params.timeout_usec);
-		client->set_decompress(false);
-		if (!http_params.bearer_token.empty()) {
-			client->set_bearer_token_auth(http_params.bearer_token.c_str());
+		auto result = std::move(entry->second.back());
+		entry->second.pop_back();
+		return result;
+	}
+
+	void StoreConnection(const string &key, unique_ptr<duckdb_httplib_openssl::Client> client, idx_t max_idle) {
+		lock_guard<mutex> guard(lock);
+		auto &connections = idle_connections[key];
+		if (connections.size() >= max_idle) {
+			// pool is full for this host: the connection is closed when the client goes out of scope
+			return;
 		}
+		connections.push_back(std::move(client));
+	}
 
-		if (!http_params.http_proxy.empty()) {
-			client->set_proxy(http_params.http_proxy, http_params.http_proxy_port);
+private:
+	mutex lock;
+	unordered_map<string, vector<unique_ptr<duckdb_httplib_openssl::Client>>> idle_connections;
+};
 
-			if (!http_params.http_proxy_username.empty()) {
-				client->set_proxy_basic_auth(http_params.http_proxy_username, http_params.http_proxy_password);
+//! Additive-increase/multiplicative-decrease limit on the number of requests in flight per endpoint. Every endpoint
+//! starts at the configured maximum, so the limiter is transparent until the server starts throttling: a 503 or 429
+//! response halves the limit (at most once per throttling episode) and a `Retry-After` header pauses the endpoint
+//! altogether, after which every successful request grows the limit again by 1/limit.
+class HTTPFSConcurrencyLimiter {
+public:
+	using steady_clock = std::chrono::steady_clock;
+
+	void Acquire(const string &key, idx_t max_limit) {
+		unique_lock<mutex> guard(lock);
+		auto &endpoint = GetEndpoint(key, max_limit);
+		while (true) {
+			auto now = steady_clock::now();
+			if (now < endpoint.blocked_until) {
+				cv.wait_until(guard, endpoint.blocked_until);
+				continue;
+			}
+			if (static_cast<double>(endpoint.in_flight) < endpoint.limit) {
+				break;
+			}
+			cv.wait(guard);
+		}
+		endpoint.in_flight++;
+	}
+
+	void Release(const string &key, idx_t max_limit, HTTPStatusCode status, idx_t retry_after_seconds) {
+		lock_guard<mutex> guard(lock);
+		auto &endpoint = GetEndpoint(key, max_limit);
+		D_ASSERT(endpoint.in_flight > 0);
+		endpoint.in_flight--;
+		auto now = steady_clock::now();
+		if (status == HTTPStatusCode::ServiceUnavailable_503 || status == HTTPStatusCode::TooManyRequests_429) {
+			// All requests that were in flight when the server started throttling come back with an error; only the
+			// first one of them shrinks the limit
+			if (now >= endpoint.decrease_cooldown_until) {
+				endpoint.limit = MaxValue<double>(endpoint.limit / 2, 1);
+				endpoint.decrease_cooldown_until = now + THROTTLE_COOLDOWN;
+			}
+			if (retry_after_seconds > 0) {
+				auto retry_after = now + std::chrono::seconds(MinValue<idx_t>(retry_after_seconds, MAX_RETRY_AFTER));
+				endpoint.blocked_until = MaxValue(endpoint.blocked_until, retry_after);
+			}
+		} else if (status != HTTPStatusCode::INVALID && static_cast<int>(status) < 500) {
+			endpoint.limit = MinValue<double>(endpoint.limit + 1 / endpoint.limit, static_cast<double>(max_limit));
+		}
+		cv.notify_all();
+	}
+
+private:
+	struct Endpoint {
+		double limit;
+		idx_t in_flight = 0;
+		steady_clock::time_point blocked_until;
+		steady_clock::time_point decrease_cooldown_until;
+	};
+
+	Endpoint &GetEndpoint(const string &key, idx_t max_limit) {
+		auto entry = endpoints.find(key);
+		if (entry == endpoints.end()) {
+			Endpoint endpoint;
+			endpoint.limit = static_cast<double>(max_limit);
+			entry = endpoints.emplace(key, endpoint).first;
+		}
+		// the maximum is a setting and can change between requests
+		entry->second.limit = MinValue<double>(entry->second.limit, static_cast<double>(max_limit));
+		return entry->second;
+	}
+
+	static constexpr std::chrono::milliseconds THROTTLE_COOLDOWN {100};
+	//! Upper bound on how long a `Retry-After` header can stall an endpoint
+	static constexpr idx_t MAX_RETRY_AFTER = 60;
+
+	mutex lock;
+	std::condition_variable cv;
+	unordered_map<string, Endpoint> endpoints;
+};
+
+constexpr std::chrono::milliseconds HTTPFSConcurrencyLimiter::THROTTLE_COOLDOWN;
+constexpr idx_t HTTPFSConcurrencyLimiter::MAX_RETRY_AFTER;
+
+//! Holds a concurrency slot for the duration of a single request
+class HTTPFSConcurrencySlot {
+public:
+	HTTPFSConcurrencySlot(optional_ptr<HTTPFSConcurrencyLimiter> limiter_p, const HTTPFSParams &params,
+	                      const string &proto_host_port, const string &path)
+	    : limiter(limiter_p), max_limit(params.max_concurrent_requests) {
+		if (!limiter || !params.adaptive_concurrency || max_limit == 0) {
+			limiter = nullptr;
+			return;
+		}
+		key = proto_host_port;
+		if (params.concurrency_per_prefix) {
+			// The first path segment: the bucket for path-style S3 urls, the top-level prefix otherwise
+			auto start = path.find_first_not_of('/');
+			if (start != string::npos) {
+				auto end = path.find_first_of("/?", start);
+				key += "/" + path.substr(start, end == string::npos ? string::npos : end - start);
+			}
+		}
+		limiter->Acquire(key, max_limit);
+	}
+	HTTPFSConcurrencySlot(const HTTPFSConcurrencySlot &) = delete;
+	~HTTPFSConcurrencySlot() {
+		if (limiter) {
+			limiter->Release(key, max_limit, status, retry_after_seconds);
+		}
+	}
+
+	void SetResponse(const HTTPResponse &response) {
+		status = response.status;
+		if (response.HasHeader("Retry-After")) {
+			// Only the delay-seconds form is supported, an HTTP-date is treated as if no delay was given
+			auto value = response.GetHeaderValue("Retry-After");
+			auto is_digit = [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; };
+			if (!value.empty() && std::all_of(value.begin(), value.end(), is_digit)) {
+				// a delay too large to represent is clamped, like any delay beyond MAX_RETRY_AFTER
+				idx_t seconds;
+				if (!TryCast::Operation<string_t, idx_t>(string_t(value), seconds, true)) {
+					seconds = NumericLimits<idx_t>::Maximum();
+				}
+				retry_after_seconds = seconds;
+			}
+		}
+	}
+
+private:
+	optional_ptr<HTTPFSConcurrencyLimiter> limiter;
+	idx_t max_limit;
+	string key;
+	HTTPStatusCode status = HTTPStatusCode::INVALID;
+	idx_t retry_after_seconds = 0;
+};
+
+//! HTTPUtil retries a request by sending the same request object again from the same thread. To count the retries
+//! that are actually sent, each thread remembers the request whose last attempt failed in a way that is retried, and
+//! how many attempts of it were sent.
+struct HTTPFSRetryTracker {
+	optional_ptr<const BaseRequest> request;
+	string url;
+	idx_t attempts = 0;
+
+	//! Called when an attempt of `request_p` is sent, returns whether it is a retry
+	bool StartAttempt(const BaseRequest &request_p) {
+		if (IsTracked(request_p) && attempts <= request_p.params.retries) {
+			return true;
+		}
+		// a new request (possibly at the address of one that ran out of retries)
+		Clear();
+		return false;
+	}
+	void FinishAttempt(const BaseRequest &request_p, bool retryable) {
+		if (!retryable) {
+			Clear();
+			return;
+		}
+		if (!IsTracked(request_p)) {
+			request = &request_p;
+			url = request_p.url;
+			attempts = 0;
+		}
+		attempts++;
+	}
+
+private:
+	bool IsTracked(const BaseRequest &request_p) const {
+		return request.get() == &request_p && url == request_p.url;
+	}
+	void Clear() {
+		request = nullptr;
+		url.clear();
+		attempts = 0;
+	}
+};
+
+static thread_local HTTPFSRetryTracker retry_tracker;
+
+//! Records a single request in the per-query statistics of its operation (see HTTPOperationStats)
+class HTTPFSRequestStats {
+public:
+	using steady_clock = std::chrono::steady_clock;
+
+	HTTPFSRequestStats(optional_ptr<HTTPState> state, optional_ptr<HTTPGlobalStats> global_stats_p, const string &host,
+	                   HTTPOperation op, bool reused_connection, optional_ptr<const BaseRequest> base_request_p)
+	    : stats(state ? &state->GetOperationStats(op) : nullptr), global_stats(global_stats_p), host(host), op(op),
+	      base_request(base_request_p), start(steady_clock::now()) {
+		request.request_count = 1;
+		if (base_request && retry_tracker.StartAttempt(*base_request)) {
+			request.retry_count = 1;
+		}
+		if (reused_connection) {
+			request.reused_connection_count = 1;
+		} else {
+			request.new_connection_count = 1;
+		}
+		if (!stats) {
+			return;
+		}
+		stats->request_count++;
+		stats->retry_count += request.retry_count;
+		if (reused_connection) {
+			stats->reused_connection_count++;
+		} else {
+			stats->new_connection_count++;
+		}
+	}
+
+	//! Recorded once, when it is destroyed (if not finished before): copies would record the request twice
+	HTTPFSRequestStats(const HTTPFSRequestStats &) = delete;
+	HTTPFSRequestStats &operator=(const HTTPFSRequestStats &) = delete;
+	HTTPFSRequestStats(HTTPFSRequestStats &&) = delete;
+	HTTPFSRequestStats &operator=(HTTPFSRequestStats &&) = delete;
+
+	~HTTPFSRequestStats() {
+		if (!finished) {
+			// An exception (e.g. thrown by a response handler) aborted the request, which HTTPUtil retries
+			Record(response_status, true);
+		}
+	}
+
+	//! Called when the response headers arrived
+	void FirstByte(HTTPStatusCode status) {
+		response_status = status;
+		if (!first_byte_received) {
+			first_byte = steady_clock::now();
+			first_byte_received = true;
+		}
+	}
+	void BytesSent(idx_t bytes) {
+		request.bytes_sent += bytes;
+		if (stats) {
+			stats->bytes_sent += bytes;
+		}
+	}
+	void BytesReceived(idx_t bytes) {
+		request.bytes_received += bytes;
+		if (stats) {
+			stats->bytes_received += bytes;
+		}
+	}
+
+	//! Called once the request completed, `status` is INVALID if the request failed without a response
+	void Finish(HTTPStatusCode status) {
+		auto code = static_cast<int>(status);
+		Record(status, status == HTTPStatusCode::INVALID || code == 408 || code == 429 || code >= 500);
+	}
+
+private:
+	void Record(HTTPStatusCode status, bool retryable) {
+		finished = true;
+		auto end = steady_clock::now();
+		auto code = static_cast<int>(status);
+		if (base_request) {
+			retry_tracker.FinishAttempt(*base_request, retryable);
+		}
+		request.total_micros = ToMicros(end - start);
+		if (global_stats) {
+			auto status_code = status == HTTPStatusCode::INVALID ? 0 : NumericCast<uint16_t>(code);
+			global_stats->Record(HTTPGlobalStatsKey {host, op, status_code}, request);
+		}
+		if (!stats) {
+			return;
+		}
+		// Requests without a response body (or without a handler for it) only have a total time
+		auto first_byte_time = first_byte_received ? first_byte : end;
+		stats->time_to_first_byte.Record(ToMicros(first_byte_time - start));
+		stats->total_time.Record(request.total_micros);
+	}
+
+	static idx_t ToMicros(steady_clock::duration duration) {
+		return NumericCast<idx_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+	}
+
+	optional_ptr<HTTPOperationStats> stats;
+	optional_ptr<HTTPGlobalStats> global_stats;
+	const string &host;
+	HTTPOperation op;
+	//! The request of HTTPUtil this is an attempt of, if it is sent through its retry logic
+	optional_ptr<const BaseRequest> base_request;
+	HTTPGlobalStatsEntry request;
+	steady_clock::time_point start;
+	steady_clock::time_point first_byte;
+	bool first_byte_received = false;
+	//! Status of the last response headers that arrived (of the last redirect, if any)
+	HTTPStatusCode response_status = HTTPStatusCode::INVALID;
+	bool finished = false;
+};
+
+//! Every setting that is baked into a duckdb_httplib_openssl::Client must be part of the key, so that a pooled
+//! connection is only handed out to a client that would have configured it identically
+static string GetConnectionPoolKey(const HTTPFSParams &http_params, const string &proto_host_port) {
+	string key = proto_host_port;
+	key += "|" + to_string(http_params.follow_location) + to_string(http_params.keep_alive) +
+	       to_string(http_params.enable_server_cert_verification);
+	key += "|" + to_string(http_params.timeout) + "." + to_string(http_params.timeout_usec);
+	key += "|" + http_params.ca_cert_file;
+	key += "|" + http_params.bearer_token;
+	key += "|" + http_params.http_proxy + ":" + to_string(http_params.http_proxy_port);
+	key += "|" + http_params.http_proxy_username + ":" + http_params.http_proxy_password;
+	return key;
+}
+
+//! The headers of a successful range response that readers use: which part of the file was returned, and which
+//! version of the file it was read from. Range responses only carry these over, instead of copying every header.
+static const char *const RANGE_RESPONSE_HEADERS[] = {"Content-Length", "Content-Range", "ETag", "Last-Modified"};
+
+static void CopyRangeResponseHeaders(const duckdb_httplib_openssl::Response &response, HTTPHeaders &headers) {
+	for (auto header : RANGE_RESPONSE_HEADERS) {
+		auto entry = response.headers.find(header);
+		if (entry != response.headers.end()) {
+			headers.Insert(header, entry->second);
+		}
+	}
+}
+
+class HTTPFSClient : public HTTPClient {
+public:
+	HTTPFSClient(HTTPFSParams &http_params, const string &proto_host_port, shared_ptr<HTTPFSConnectionPool> pool_p,
+	             shared_ptr<HTTPFSConcurrencyLimiter> limiter_p, shared_ptr<HTTPGlobalStats> global_stats_p)
+	    : proto_host_port(proto_host_port), pool(std::move(pool_p)), limiter(std::move(limiter_p)),
+	      global_stats(std::move(global_stats_p)),
+	      max_idle_connections(http_params.connection_pool_size), keep_alive(http_params.keep_alive) {
+		if (pool && http_params.keep_alive && max_idle_connections > 0) {
+			pool_key = GetConnectionPoolKey(http_params, proto_host_port);
+			client = pool->GetConnection(pool_key);
+			if (client) {
+				connection_open = true;
+				return;
 			}
+		} else {
+			pool = nullptr;
+		}
+		client = CreateConnection(http_params, proto_host_port);
+	}
+
+	~HTTPFSClient() override {
+		// Hand the (possibly still open) connection back so that the next client for this host can skip the
+		// TCP and TLS handshakes. Only connections whose last request completed are reused: after a transport error,
+		// or an exception thrown by a handler, the rest of that response may still be waiting on the socket.
+		if (pool && client && !request_in_progress) {
+			pool->StoreConnection(pool_key, std::move(client), max_idle_connections);
 		}
-		state = http_params.state;
 	}
 
 	unique_ptr<HTTPResponse> Get(GetRequestInfo &info) override {
+		auto state = GetState(info);
 		if (state) {
 			state->get_count++;
 		}
 		auto headers = TransformHeaders(info.headers, info.params);
+		HTTPFSConcurrencySlot slot(limiter.get(), info.params.Cast<HTTPFSParams>(), proto_host_port, info.path);
+		BeginRequest(info.params.Cast<HTTPFSParams>());
+		HTTPFSRequestStats request_stats(state, global_stats.get(), proto_host_port, HTTPOperation::GET_OP,
+		                                 connection_open, &info);
 		if (!info.response_handler && !info.content_handler) {
-			return TransformResult(client->Get(info.path, headers));
+			return TransformResult(client->Get(info.path, headers), slot, request_stats);
+		}
+		auto range_writer = info.content_handler.target<HTTPFSRangeWriter>();
+		if (range_writer && info.response_handler) {
+			// Fast path for range reads: the socket reader writes into the destination buffer directly, and the
+			// response handler only gets the headers it needs for successful responses
+			return TransformResult(client->Get(
+			    info.path.c_str(), headers,
+			    [&](const duckdb_httplib_openssl::Response &response) {
+				    request_stats.FirstByte(HTTPUtil::ToStatusCode(response.status));
+				    if (response.status >= 300) {
+					    auto http_response = TransformResponse(response);
+					    // the handler throws for error responses, so the slot has to learn about them first
+					    slot.SetResponse(*http_response);
+					    return info.response_handler(*http_response);
+				    }
+				    HTTPResponse http_response(HTTPUtil::ToStatusCode(response.status));
+				    CopyRangeResponseHeaders(response, http_response.headers);
+				    slot.SetResponse(http_response);
+				    return info.response_handler(http_response);
+			    },
+			    [&](const char *data, size_t data_length) {
+				    if (state) {
+					    state->total_bytes_received += data_length;
+				    }
+				    request_stats.BytesReceived(data_length);
+				    return range_writer->Write(const_data_ptr_cast(data), data_length);
+			    }),
+			    slot, request_stats, true);
 		} else {
 			return TransformResult(client->Get(
 			    info.path.c_str(), headers,
 			    [&](const duckdb_httplib_openssl::Response &response) {
+				    request_stats.FirstByte(HTTPUtil::ToStatusCode(response.status));
 				    auto http_response = TransformResponse(response);
+				    slot.SetResponse(*http_response);
 				    return info.response_handler(*http_response);
 			    },
 			    [&](const char *data, size_t data_length) {
 				    if (state) {
 					    state->total_bytes_received += data_length;
 				    }
+				    request_stats.BytesReceived(data_length);
 				    return info.content_handler(const_data_ptr_cast(data), data_length);
-			    }));
+			    }),
+			    slot, request_stats);
 		}
 	}
 	unique_ptr<HTTPResponse> Put(PutRequestInfo &info) override {
+		auto state = GetState(info);
 		if (state) {
 			state->put_count++;
 			state->total_bytes_sent += info.buffer_in_len;
 		}
 		auto headers = TransformHeaders(info.headers, info.params);
+		HTTPFSConcurrencySlot slot(limiter.get(), info.params.Cast<HTTPFSParams>(), proto_host_port, info.path);
+		BeginRequest(info.params.Cast<HTTPFSParams>());
+		HTTPFSRequestStats request_stats(state, global_stats.get(), proto_host_port, HTTPOperation::PUT_OP,
+		                                 connection_open, &info);
+		request_stats.BytesSent(info.buffer_in_len);
 		return TransformResult(client->Put(info.path, headers, const_char_ptr_cast(info.buffer_in), info.buffer_in_len,
-		                                   info.content_type));
+		                                   info.content_type),
+		                       slot, request_stats);
 	}
 
 	unique_ptr<HTTPResponse> Head(HeadRequestInfo &info) override {
+		auto state = GetState(info);
 		if (state) {
 			state->head_count++;
 		}
 		auto headers = TransformHeaders(info.headers, info.params);
-		return TransformResult(client->Head(info.path, headers));
+		HTTPFSConcurrencySlot slot(limiter.get(), info.params.Cast<HTTPFSParams>(), proto_host_port, info.path);
+		BeginRequest(info.params.Cast<HTTPFSParams>());
+		HTTPFSRequestStats request_stats(state, global_stats.get(), proto_host_port, HTTPOperation::HEAD_OP,
+		                                 connection_open, &info);
+		return TransformResult(client->Head(info.path, headers), slot, request_stats);
 	}
 
 	unique_ptr<HTTPResponse> Delete(DeleteRequestInfo &info) override {
+		auto state = GetState(info);
 		if (state) {
 			state->delete_count++;
 		}
 		auto headers = TransformHeaders(info.headers, info.params);
-		return TransformResult(client->Delete(info.path, headers));
+		HTTPFSConcurrencySlot slot(limiter.get(), info.params.Cast<HTTPFSParams>(), proto_host_port, info.path);
+		BeginRequest(info.params.Cast<HTTPFSParams>());
+		HTTPFSRequestStats request_stats(state, global_stats.get(), proto_host_port, HTTPOperation::DELETE_OP,
+		                                 connection_open, &info);
+		return TransformResult(client->Delete(info.path, headers), slot, request_stats);
 	}
 
 	unique_ptr<HTTPResponse> Post(PostRequestInfo &info) override {
+		auto state = GetState(info);
 		if (state) {
 			state->post_count++;
 			state->total_bytes_sent += info.buffer_in_len;
@@ -95,19 +501,119 @@ public:
 		if (req.headers.find("Content-Type") == req.headers.end()) {
 			req.headers.emplace("Content-Type", "application/octet-stream");
 		}
+		HTTPFSConcurrencySlot slot(limiter.get(), info.params.Cast<HTTPFSParams>(), proto_host_port, info.path);
+		BeginRequest(info.params.Cast<HTTPFSParams>());
+		HTTPFSRequestStats request_stats(state, global_stats.get(), proto_host_port, HTTPOperation::POST_OP,
+		                                 connection_open, &info);
+		request_stats.BytesSent(info.buffer_in_len);
+		req.response_handler = [&](const duckdb_httplib_openssl::Response &response) {
+			request_stats.FirstByte(HTTPUtil::ToStatusCode(response.status));
+			return true;
+		};
 		req.content_receiver = [&](const char *data, size_t data_length, uint64_t /*offset*/,
 		                           uint64_t /*total_length*/) {
 			if (state) {
 				state->total_bytes_received += data_length;
 			}
+			request_stats.BytesReceived(data_length);
 			info.buffer_out += string(data, data_length);
 			return true;
 		};
 		req.body.assign(const_char_ptr_cast(info.buffer_in), info.buffer_in_len);
-		return TransformResult(client->send(req));
+		return TransformResult(client->send(req), slot, request_stats);
+	}
+
+	unique_ptr<HTTPResponse> SendStreaming(HTTPFSParams &params, const string &method, const string &path,
+	                                       const HTTPHeaders &header_map, const HTTPBodySource &body_source) {
+		optional_ptr<HTTPState> state = params.state.get();
+		auto is_post = method == "POST";
+		if (state) {
+			if (is_post) {
+				state->post_count++;
+			} else {
+				state->put_count++;
+			}
+		}
+		auto headers = TransformHeaders(header_map, params);
+		HTTPFSConcurrencySlot slot(limiter.get(), params, proto_host_port, path);
+		BeginRequest(params);
+		auto op = is_post ? HTTPOperation::POST_OP : HTTPOperation::PUT_OP;
+		HTTPFSRequestStats request_stats(state, global_stats.get(), proto_host_port, op, connection_open, nullptr);
+		ErrorData body_error;
+		string chunk;
+		auto content_provider = [&](size_t /*offset*/, duckdb_httplib_openssl::DataSink &sink) {
+			try {
+				if (!body_source(chunk)) {
+					sink.done();
+					return true;
+				}
+			} catch (std::exception &ex) {
+				body_error = ErrorData(ex);
+				return false;
+			}
+			if (chunk.empty()) {
+				// an empty chunk would terminate the chunked body
+				return true;
+			}
+			if (state) {
+				state->total_bytes_sent += chunk.size();
+			}
+			request_stats.BytesSent(chunk.size());
+			return sink.write(chunk.data(), chunk.size());
+		};
+		static constexpr const char *CONTENT_TYPE = "application/octet-stream";
+		auto result = is_post ? client->Post(path, headers, content_provider, CONTENT_TYPE)
+		                      : client->Put(path, headers, content_provider, CONTENT_TYPE);
+		auto response = TransformResult(std::move(result), slot, request_stats);
+		if (body_error.HasError()) {
+			body_error.Throw();
+		}
+		return response;
 	}
 
 private:
+	static unique_ptr<duckdb_httplib_openssl::Client> CreateConnection(const HTTPFSParams &http_params,
+	                                                                   const string &proto_host_port) {
+		auto client = make_uniq<duckdb_httplib_openssl::Client>(proto_host_port);
+		client->set_follow_location(http_params.follow_location);
+		client->set_keep_alive(http_params.keep_alive);
+		if (!http_params.ca_cert_file.empty()) {
+			client->set_ca_cert_path(http_params.ca_cert_file.c_str());
+		}
+		client->enable_server_certificate_verification(http_params.enable_server_cert_verification);
+		client->set_write_timeout(http_params.timeout, http_params.timeout_usec);
+		client->set_read_timeout(http_params.timeout, http_params.timeout_usec);
+		client->set_connection_timeout(http_params.timeout, http_params.timeout_usec);
+		client->set_decompress(false);
+		if (!http_params.bearer_token.empty()) {
+			client->set_bearer_token_auth(http_params.bearer_token.c_str());
+		}
+
+		if (!http_params.http_proxy.empty()) {
+			client->set_proxy(http_params.http_proxy, http_params.http_proxy_port);
+
+			if (!http_params.http_proxy_username.empty()) {
+				client->set_proxy_basic_auth(http_params.http_proxy_username, http_params.http_proxy_password);
+			}
+		}
+		return client;
+	}
+
+	//! Called before every request. If the previous request on this client did not complete, its connection may still
+	//! hold the rest of that response, which the next request would read as its own: open a new connection instead.
+	void BeginRequest(const HTTPFSParams &params) {
+		if (request_in_progress) {
+			client = CreateConnection(params, proto_host_port);
+			connection_open = false;
+		}
+		request_in_progress = true;
+	}
+
+	//! The state is looked up per request, as pooled connections outlive the query that created them
+	static optional_ptr<HTTPState> GetState(BaseRequest &info) {
+		return info.params.Cast<HTTPFSParams>().state.get();
+	}
+
 	duckdb_httplib_openssl::Headers TransformHeaders(const HTTPHeaders &header_map, const HTTPParams &params) {
 		duckdb_httplib_openssl::Headers headers;
 		for (auto &entry : header_map) {
@@ -130,11 +636,27 @@ private:
 		return result;
 	}
 
-	unique_ptr<HTTPResponse> TransformResult(duckdb_httplib_openssl::Result &&res) {
+	//! Successful range responses (`range_response`) are transformed with only the headers that readers use
+	unique_ptr<HTTPResponse> TransformResult(duckdb_httplib_openssl::Result &&res, HTTPFSConcurrencySlot &slot,
+	                                         HTTPFSRequestStats &request_stats, bool range_response = false) {
 		if (res.error() == duckdb_httplib_openssl::Error::Success) {
 			auto &response = res.value();
-			return TransformResponse(response);
+			unique_ptr<HTTPResponse> result;
+			if (range_response && response.status < 300) {
+				// the body went straight into the destination buffer
+				result = make_uniq<HTTPResponse>(HTTPUtil::ToStatusCode(response.status));
+				CopyRangeResponseHeaders(response, result->headers);
+			} else {
+				result = TransformResponse(response);
+			}
+			slot.SetResponse(*result);
+			request_stats.Finish(result->status);
+			connection_open = keep_alive;
+			request_in_progress = false;
+			return result;
 		} else {
+			connection_open = false;
+			request_stats.Finish(HTTPStatusCode::INVALID);
 			auto result = make_uniq<HTTPResponse>(HTTPStatusCode::INVALID);
 			result->request_error = to_string(res.error());
 			return result;
@@ -143,14 +665,52 @@ private:
 
 private:
 	unique_ptr<duckdb_httplib_openssl::Client> client;
-	optional_ptr<HTTPState> state;
+	string proto_host_port;
+	shared_ptr<HTTPFSConnectionPool> pool;
+	shared_ptr<HTTPFSConcurrencyLimiter> limiter;
+	shared_ptr<HTTPGlobalStats> global_stats;
+	string pool_key;
+	idx_t max_idle_connections;
+	bool keep_alive;
+	//! Set while a request is sent, and left set if it did not complete (i.e. failed or was aborted by an exception)
+	bool request_in_progress = false;
+	//! Whether the next request can be sent over an already open connection
+	bool connection_open = false;
 };
 
+shared_ptr<HTTPFSConnectionPool> HTTPFSUtil::GetConnectionPool() {
+	lock_guard<mutex> guard(connection_pool_lock);
+	if (!connection_pool) {
+		connection_pool = make_shared_ptr<HTTPFSConnectionPool>();
+	}
+	return connection_pool;
+}
+
+shared_ptr<HTTPFSConcurrencyLimiter> HTTPFSUtil::GetConcurrencyLimiter() {
+	lock_guard<mutex> guard(connection_pool_lock);
+	if (!concurrency_limiter) {
+		concurrency_limiter = make_shared_ptr<HTTPFSConcurrencyLimiter>();
+	}
+	return concurrency_limiter;
+}
+
 unique_ptr<HTTPClient> HTTPFSUtil::InitializeClient(HTTPParams &http_params, const string &proto_host_port) {
-	auto client = make_uniq<HTTPFSClient>(http_params.Cast<HTTPFSParams>(), proto_host_port);
+	auto client = make_uniq<HTTPFSClient>(http_params.Cast<HTTPFSParams>(), proto_host_port, GetConnectionPool(),
+	                                      GetConcurrencyLimiter(), GetGlobalStats());
 	return std::move(client);
 }
 
+unique_ptr<HTTPResponse> HTTPFSUtil::SendStreamingRequest(HTTPFSParams &params, const string &method,
+                                                          const string &url, const HTTPHeaders &headers,
+                                                          const HTTPBodySource &body_source) {
+	string path, proto_host_port;
+	HTTPUtil::DecomposeURL(url, path, proto_host_port);
+	// the body cannot be replayed, so the request cannot be resent if a pooled connection turns out to have been
+	// closed by the server while idle: always send it over a fresh connection (which is not returned to the pool)
+	HTTPFSClient client(params, proto_host_port, nullptr, GetConcurrencyLimiter(), GetGlobalStats());
+	return client.SendStreaming(params, method, path, headers, body_source);
+}
+
 unordered_map<string, string> HTTPFSUtil::ParseGetParameters(const string &text) {
 	duckdb_httplib_openssl::Params query_params;
 	duckdb_httplib_openssl::detail::parse_query_text(text, query_params);
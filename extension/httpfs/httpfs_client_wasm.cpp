@@ -7,6 +7,12 @@ unique_ptr<HTTPClient> HTTPFSUtil::InitializeClient(HTTPParams &http_params, con
 	throw InternalException("HTTPFSUtil::InitializeClient is not expected to be called");
 }
 
+unique_ptr<HTTPResponse> HTTPFSUtil::SendStreamingRequest(HTTPFSParams &params, const string &method,
+                                                          const string &url, const HTTPHeaders &headers,
+                                                          const HTTPBodySource &body_source) {
+	throw NotImplementedException("Streaming uploads are not supported in DuckDB-Wasm");
+}
+
 unordered_map<string, string> HTTPFSUtil::ParseGetParameters(const string &text) {
 	unordered_map<string, string> result;
 	//TODO: HTTPFSUtil::ParseGetParameters is currently not implemented
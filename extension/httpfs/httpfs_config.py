@@ -3,7 +3,13 @@ import os
 # list all include directories
 include_directories = [
     os.path.sep.join(x.split('/'))
-    for x in ['extension/httpfs/include', 'third_party/httplib', 'extension/parquet/include']
+    for x in [
+        'extension/httpfs/include',
+        'third_party/httplib',
+        'third_party/miniz',
+        'third_party/zstd/include',
+        'extension/parquet/include',
+    ]
 ]
 # source files
 source_files = [
@@ -14,10 +20,15 @@ source_files = [
             'create_secret_functions.cpp',
             'crypto.cpp',
             'hffs.cpp',
+            'http_content_decoder.cpp',
+            'http_io_executor.cpp',
+            'http_streaming_upload.cpp',
             'http_state.cpp',
             'httpfs.cpp',
             'httpfs_extension.cpp',
             'httpfs_client.cpp',
+            'httpfs_internal_functions.cpp',
+            'httpfs_stats_functions.cpp',
             's3fs.cpp',
         ]
     ]
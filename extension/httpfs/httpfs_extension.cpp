@@ -4,6 +4,8 @@
 
 #include "create_secret_functions.hpp"
 #include "duckdb.hpp"
+#include "httpfs_internal_functions.hpp"
+#include "httpfs_stats_functions.hpp"
 #include "s3fs.hpp"
 #include "hffs.hpp"
 #ifdef OVERRIDE_ENCRYPTION_UTILS
@@ -22,7 +24,7 @@ static void SetHttpfsClientImplementation(DBConfig &config, const string &value)
 			                            "`default` are currently supported for duckdb-wasm");
 		}
 		if (value == "httplib" || value == "default") {
-			if (!config.http_util || config.http_util->GetName() != "HTTPFSUtil") {
+			if (!config.http_util || config.http_util->GetName() != "HTTPFS") {
 				config.http_util = make_shared_ptr<HTTPFSUtil>();
 			}
 			return;
@@ -59,6 +61,64 @@ static void LoadInternal(DatabaseInstance &instance) {
 	                          LogicalType::BOOLEAN, Value(false));
 	config.AddExtensionOption("ca_cert_file", "Path to a custom certificate file for self-signed certificates.",
 	                          LogicalType::VARCHAR, Value(""));
+	config.AddExtensionOption("http_connection_pool_size",
+	                          "Maximum number of idle keep-alive connections per host that are shared between file "
+	                          "handles. Setting this to 0 disables connection pooling",
+	                          LogicalType::UBIGINT, Value::UBIGINT(HTTPFSParams::DEFAULT_CONNECTION_POOL_SIZE));
+	config.AddExtensionOption("http_prewarm_connections",
+	                          "Number of connections to open in parallel when a glob resolves to many files on the same "
+	                          "host (bounded by http_connection_pool_size)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(HTTPFSParams::DEFAULT_PREWARM_CONNECTIONS));
+	config.AddExtensionOption("http_tail_prefetch_size",
+	                          "Number of bytes at the end of a Parquet file that are fetched in a single request by the "
+	                          "first read of the footer, so that the metadata reads are served from memory. The bytes "
+	                          "beyond the metadata are fetched in vain (0, the default, disables)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(HTTPFSParams::DEFAULT_TAIL_PREFETCH_SIZE));
+	config.AddExtensionOption("http_probe_read_size",
+	                          "Open files for reading with a range GET of this many bytes instead of a HEAD request, taking "
+	                          "the file size from Content-Range and keeping the bytes as first read buffer (0 uses HEAD)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(HTTPFSParams::DEFAULT_PROBE_READ_SIZE));
+	config.AddExtensionOption("http_max_ranges_per_request",
+	                          "Maximum number of ranges requested together (as multipart/byteranges) when reading multiple "
+	                          "ranges of a plain http(s) file (0 or 1 requests every range separately)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(HTTPFSParams::DEFAULT_MAX_RANGES_PER_REQUEST));
+	config.AddExtensionOption("http_read_ranges_concurrency",
+	                          "Number of concurrent requests when multiple ranges of a file are read one range at a time",
+	                          LogicalType::UBIGINT, Value::UBIGINT(HTTPFSParams::DEFAULT_READ_RANGES_CONCURRENCY));
+	config.AddExtensionOption("http_read_coalesce_gap",
+	                          "Ranges of a vectored read that are at most this many bytes apart are fetched as one range",
+	                          LogicalType::UBIGINT, Value::UBIGINT(HTTPFSParams::DEFAULT_READ_COALESCE_GAP));
+	config.AddExtensionOption("http_hedge_percentile",
+	                          "Send a duplicate range request on another connection when the first byte has not arrived "
+	                          "after this percentile of the host's observed latency, e.g. 0.95 (0 disables hedging)",
+	                          LogicalType::DOUBLE, Value::DOUBLE(HTTPFSParams::DEFAULT_HEDGE_PERCENTILE));
+	config.AddExtensionOption("http_adaptive_concurrency",
+	                          "Adaptively limit the number of concurrent requests per endpoint: the limit is halved when "
+	                          "the server responds with 503 or 429 (honouring Retry-After) and grows back on success",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(HTTPFSParams::DEFAULT_ADAPTIVE_CONCURRENCY));
+	config.AddExtensionOption("http_max_concurrent_requests",
+	                          "Maximum number of concurrent requests per endpoint when http_adaptive_concurrency is set",
+	                          LogicalType::UBIGINT, Value::UBIGINT(HTTPFSParams::DEFAULT_MAX_CONCURRENT_REQUESTS));
+	config.AddExtensionOption("http_concurrency_per_prefix",
+	                          "Track the adaptive concurrency limit per first path segment (bucket or top-level prefix) "
+	                          "instead of per host",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(HTTPFSParams::DEFAULT_CONCURRENCY_PER_PREFIX));
+	config.AddExtensionOption("http_io_threads",
+	                          "Maximum number of threads of the database that run the concurrent HTTP requests of "
+	                          "multi-range reads, asynchronous reads, connection pre-warming and request hedging; every "
+	                          "request blocks one thread, so this bounds how many of them are in flight",
+	                          LogicalType::UBIGINT, Value::UBIGINT(HTTPFSParams::DEFAULT_IO_THREADS));
+	config.AddExtensionOption("http_write_method",
+	                          "HTTP method used to upload files written to http(s):// URLs, PUT or POST",
+	                          LogicalType::VARCHAR, Value(HTTPFSParams::DEFAULT_WRITE_METHOD));
+	config.AddExtensionOption("http_write_buffer_size",
+	                          "Maximum number of bytes of a file written to an http(s):// URL that are buffered before "
+	                          "they are sent",
+	                          LogicalType::UBIGINT, Value::UBIGINT(HTTPFSParams::DEFAULT_WRITE_BUFFER_SIZE));
+	config.AddExtensionOption("http_compressed_downloads",
+	                          "Request gzip or zstd compressed responses when downloading whole files (e.g. with "
+	                          "force_download), decompressing them while they are received",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(HTTPFSParams::DEFAULT_COMPRESSED_DOWNLOADS));
 	// Global S3 config
 	config.AddExtensionOption("s3_region", "S3 Region", LogicalType::VARCHAR, Value("us-east-1"));
 	config.AddExtensionOption("s3_access_key_id", "S3 Access Key ID", LogicalType::VARCHAR);
@@ -71,6 +131,11 @@ static void LoadInternal(DatabaseInstance &instance) {
 	config.AddExtensionOption("s3_url_compatibility_mode", "Disable Globs and Query Parameters on S3 URLs",
 	                          LogicalType::BOOLEAN, Value(false));
 	config.AddExtensionOption("s3_requester_pays", "S3 use requester pays mode", LogicalType::BOOLEAN, Value(false));
+	config.AddExtensionOption("s3_credential_refresh_margin",
+	                          "Seconds before the expiration of temporary S3 credentials at which they are refreshed. "
+	                          "Refreshed credentials only expire again if the EXPIRATION is part of the secret's "
+	                          "REFRESH_INFO; secrets with REFRESH 'auto' are refreshed ahead of time only once",
+	                          LogicalType::BIGINT, Value::BIGINT(S3AuthParams::DEFAULT_REFRESH_MARGIN));
 
 	// S3 Uploader config
 	config.AddExtensionOption("s3_uploader_max_filesize", "S3 Uploader max filesize (between 50GB and 5TB)",
@@ -79,10 +144,24 @@ static void LoadInternal(DatabaseInstance &instance) {
 	                          LogicalType::UBIGINT, Value(10000));
 	config.AddExtensionOption("s3_uploader_thread_limit", "S3 Uploader global thread limit", LogicalType::UBIGINT,
 	                          Value(50));
+	config.AddExtensionOption("s3_checksum_algorithm",
+	                          "Additional checksum (NONE, CRC32C or CRC64NVME) sent with uploaded parts, and requested "
+	                          "and verified when downloading whole objects",
+	                          LogicalType::VARCHAR, Value("NONE"));
 
 	// HuggingFace options
 	config.AddExtensionOption("hf_max_per_page", "Debug option to limit number of items returned in list requests",
 	                          LogicalType::UBIGINT, Value::UBIGINT(0));
+	config.AddExtensionOption("hf_max_concurrent_listings",
+	                          "Maximum number of directories listed concurrently when expanding a HuggingFace glob",
+	                          LogicalType::UBIGINT, Value::UBIGINT(HTTPFSParams::DEFAULT_HF_MAX_CONCURRENT_LISTINGS));
+	config.AddExtensionOption("hf_cache_redirects",
+	                          "Cache where the HuggingFace hub redirects file reads to (e.g. a CDN) and send subsequent "
+	                          "range reads there directly",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(HTTPFSParams::DEFAULT_HF_CACHE_REDIRECTS));
+	config.AddExtensionOption("hf_endpoint",
+	                          "Url of the HuggingFace hub that hf:// urls are resolved against, e.g. a mirror",
+	                          LogicalType::VARCHAR, Value(HTTPFSParams::DEFAULT_HF_ENDPOINT));
 
 	auto callback_httpfs_client_implementation = [](ClientContext &context, SetScope scope, Value &parameter) {
 		auto &config = DBConfig::GetConfig(context);
@@ -100,6 +179,8 @@ static void LoadInternal(DatabaseInstance &instance) {
 
 	CreateS3SecretFunctions::Register(instance);
 	CreateBearerTokenFunctions::Register(instance);
+	HTTPFSStatsFunctions::Register(instance);
+	HTTPFSInternalFunctions::Register(instance);
 
 #ifdef OVERRIDE_ENCRYPTION_UTILS
 	// set pointer to OpenSSL encryption state
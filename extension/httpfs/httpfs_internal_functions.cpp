@@ -0,0 +1,350 @@
+#include "httpfs_internal_functions.hpp"
+
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/thread.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "http_io_executor.hpp"
+#include "httpfs.hpp"
+
+namespace duckdb {
+
+//! How __internal_httpfs_read_ranges reads its ranges
+enum class HTTPFSReadMode : uint8_t {
+	//! One (unbuffered) Read per range
+	READ,
+	//! ReadRanges: multipart/byteranges requests, or concurrent single range requests
+	RANGES,
+	//! ReadV: ranges that are close to each other are coalesced before they are fetched through ReadRanges
+	VECTORED,
+	//! One ReadAsync per range, all started before waiting for any of them
+	ASYNC
+};
+
+struct HTTPFSReadRangesBindData : public TableFunctionData {
+	string url;
+	vector<idx_t> offsets;
+	vector<idx_t> lengths;
+	HTTPFSReadMode mode = HTTPFSReadMode::RANGES;
+};
+
+struct HTTPFSReadRangesState : public GlobalTableFunctionState {
+	vector<string> data;
+	idx_t offset = 0;
+};
+
+static HTTPFSReadMode ParseReadMode(const string &mode) {
+	auto lower = StringUtil::Lower(mode);
+	if (lower == "read") {
+		return HTTPFSReadMode::READ;
+	}
+	if (lower == "ranges") {
+		return HTTPFSReadMode::RANGES;
+	}
+	if (lower == "vectored") {
+		return HTTPFSReadMode::VECTORED;
+	}
+	if (lower == "async") {
+		return HTTPFSReadMode::ASYNC;
+	}
+	throw InvalidInputException(
+	    "Unknown mode '%s' of __internal_httpfs_read_ranges, expected 'read', 'ranges', 'vectored' or 'async'", mode);
+}
+
+static vector<idx_t> GetListArgument(const Value &value, const string &name) {
+	if (value.IsNull()) {
+		throw InvalidInputException("The %s of __internal_httpfs_read_ranges must not be NULL", name);
+	}
+	vector<idx_t> result;
+	for (auto &child : ListValue::GetChildren(value)) {
+		if (child.IsNull()) {
+			throw InvalidInputException("The %s of __internal_httpfs_read_ranges must not contain NULL", name);
+		}
+		result.push_back(child.GetValue<uint64_t>());
+	}
+	return result;
+}
+
+static unique_ptr<FunctionData> HTTPFSReadRangesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<HTTPFSReadRangesBindData>();
+	if (input.inputs[0].IsNull()) {
+		throw InvalidInputException("The url of __internal_httpfs_read_ranges must not be NULL");
+	}
+	result->url = StringValue::Get(input.inputs[0]);
+	result->offsets = GetListArgument(input.inputs[1], "offsets");
+	result->lengths = GetListArgument(input.inputs[2], "lengths");
+	if (result->offsets.size() != result->lengths.size()) {
+		throw InvalidInputException("__internal_httpfs_read_ranges needs as many lengths as offsets");
+	}
+	for (auto &kv : input.named_parameters) {
+		if (kv.first == "mode") {
+			result->mode = ParseReadMode(StringValue::Get(kv.second));
+		}
+	}
+	names.emplace_back("offset");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("length");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("data");
+	return_types.emplace_back(LogicalType::BLOB);
+	return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> HTTPFSReadRangesInit(ClientContext &context,
+                                                                 TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<HTTPFSReadRangesBindData>();
+	auto result = make_uniq<HTTPFSReadRangesState>();
+
+	// Opened like scanners do, so that reads are not buffered by the handle
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto handle = fs.OpenFile(bind_data.url, FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_PARALLEL_ACCESS);
+	auto http_fs = dynamic_cast<HTTPFileSystem *>(&handle->file_system);
+	if (!http_fs) {
+		throw InvalidInputException("__internal_httpfs_read_ranges can only read files over HTTP(S), S3 or HuggingFace, "
+		                            "not '%s'",
+		                            bind_data.url);
+	}
+	auto file_size = NumericCast<idx_t>(http_fs->GetFileSize(*handle));
+
+	vector<HTTPFileRange> ranges;
+	for (idx_t i = 0; i < bind_data.offsets.size(); i++) {
+		auto offset = bind_data.offsets[i];
+		auto length = bind_data.lengths[i];
+		if (offset > file_size || length > file_size - offset) {
+			throw InvalidInputException("Range of %llu bytes at offset %llu is past the end of '%s' (%llu bytes)",
+			                            length, offset, bind_data.url, file_size);
+		}
+		result->data.emplace_back(length, '\0');
+	}
+	for (idx_t i = 0; i < bind_data.offsets.size(); i++) {
+		auto buffer = data_ptr_cast(&result->data[i][0]);
+		ranges.push_back(HTTPFileRange {bind_data.offsets[i], bind_data.lengths[i], buffer});
+	}
+
+	switch (bind_data.mode) {
+	case HTTPFSReadMode::READ:
+		for (auto &range : ranges) {
+			http_fs->Read(*handle, range.buffer, NumericCast<int64_t>(range.length), range.offset);
+		}
+		break;
+	case HTTPFSReadMode::RANGES:
+		http_fs->ReadRanges(*handle, ranges);
+		break;
+	case HTTPFSReadMode::VECTORED:
+		http_fs->ReadV(*handle, ranges);
+		break;
+	case HTTPFSReadMode::ASYNC: {
+		HTTPCompletionQueue queue;
+		for (idx_t i = 0; i < ranges.size(); i++) {
+			auto &range = ranges[i];
+			http_fs->ReadAsync(*handle, range.buffer, range.length, range.offset, queue, i);
+		}
+		queue.WaitAll();
+		break;
+	}
+	}
+	return std::move(result);
+}
+
+static void HTTPFSReadRangesFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &bind_data = data_p.bind_data->Cast<HTTPFSReadRangesBindData>();
+	auto &state = data_p.global_state->Cast<HTTPFSReadRangesState>();
+	idx_t count = 0;
+	while (state.offset < state.data.size() && count < STANDARD_VECTOR_SIZE) {
+		auto i = state.offset++;
+		auto &data = state.data[i];
+		output.SetValue(0, count, Value::UBIGINT(bind_data.offsets[i]));
+		output.SetValue(1, count, Value::UBIGINT(bind_data.lengths[i]));
+		output.SetValue(2, count, Value::BLOB(const_data_ptr_cast(data.data()), data.size()));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+//! In which order __internal_httpfs_write_parts writes the chunks of its file
+enum class HTTPFSWriteOrder : uint8_t {
+	//! From the last chunk to the first
+	REVERSE,
+	//! Interleaved over several threads, that each write their chunks front to back
+	THREADS,
+	//! Front to back, but leaving out a chunk in the middle of the file
+	GAP,
+	//! Front to back, and then the first chunk once more
+	REWRITE
+};
+
+//! Every row of the file written by __internal_httpfs_write_parts is its number, zero-padded to 15 digits
+static constexpr idx_t WRITE_ROW_WIDTH = 16;
+//! Threads that write the chunks in the THREADS order
+static constexpr idx_t WRITE_THREADS = 4;
+
+struct HTTPFSWritePartsBindData : public TableFunctionData {
+	string url;
+	idx_t rows;
+	idx_t chunk_rows;
+	HTTPFSWriteOrder order = HTTPFSWriteOrder::REVERSE;
+};
+
+struct HTTPFSWritePartsState : public GlobalTableFunctionState {
+	idx_t bytes_written = 0;
+	bool finished = false;
+};
+
+static HTTPFSWriteOrder ParseWriteOrder(const string &order) {
+	auto lower = StringUtil::Lower(order);
+	if (lower == "reverse") {
+		return HTTPFSWriteOrder::REVERSE;
+	}
+	if (lower == "threads") {
+		return HTTPFSWriteOrder::THREADS;
+	}
+	if (lower == "gap") {
+		return HTTPFSWriteOrder::GAP;
+	}
+	if (lower == "rewrite") {
+		return HTTPFSWriteOrder::REWRITE;
+	}
+	throw InvalidInputException(
+	    "Unknown order '%s' of __internal_httpfs_write_parts, expected 'reverse', 'threads', 'gap' or 'rewrite'", order);
+}
+
+static string GenerateRows(idx_t first_row, idx_t row_count) {
+	string result;
+	result.reserve(row_count * WRITE_ROW_WIDTH);
+	for (idx_t row = first_row; row < first_row + row_count; row++) {
+		auto digits = to_string(row);
+		result.append(WRITE_ROW_WIDTH - 1 - digits.size(), '0');
+		result += digits;
+		result += '\n';
+	}
+	return result;
+}
+
+static unique_ptr<FunctionData> HTTPFSWritePartsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<HTTPFSWritePartsBindData>();
+	for (auto &value : input.inputs) {
+		if (value.IsNull()) {
+			throw InvalidInputException("The arguments of __internal_httpfs_write_parts must not be NULL");
+		}
+	}
+	result->url = StringValue::Get(input.inputs[0]);
+	result->rows = input.inputs[1].GetValue<uint64_t>();
+	result->chunk_rows = input.inputs[2].GetValue<uint64_t>();
+	if (result->rows < 2 || result->chunk_rows == 0) {
+		throw InvalidInputException("__internal_httpfs_write_parts needs at least 2 rows, in chunks of at least 1 row");
+	}
+	for (auto &kv : input.named_parameters) {
+		if (kv.first == "order") {
+			result->order = ParseWriteOrder(StringValue::Get(kv.second));
+		}
+	}
+	names.emplace_back("bytes_written");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> HTTPFSWritePartsInit(ClientContext &context,
+                                                                 TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<HTTPFSWritePartsBindData>();
+	auto result = make_uniq<HTTPFSWritePartsState>();
+
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto handle = fs.OpenFile(bind_data.url, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+
+	// All rows but the last are written in chunks at their offset, in the requested order
+	vector<pair<idx_t, idx_t>> chunks;
+	auto last_row = bind_data.rows - 1;
+	for (idx_t row = 0; row < last_row; row += bind_data.chunk_rows) {
+		chunks.emplace_back(row, MinValue<idx_t>(bind_data.chunk_rows, last_row - row));
+	}
+	auto write_chunk = [&](const pair<idx_t, idx_t> &chunk) {
+		auto data = GenerateRows(chunk.first, chunk.second);
+		handle->Write(&data[0], data.size(), chunk.first * WRITE_ROW_WIDTH);
+	};
+	switch (bind_data.order) {
+	case HTTPFSWriteOrder::REVERSE:
+		for (auto chunk = chunks.rbegin(); chunk != chunks.rend(); chunk++) {
+			write_chunk(*chunk);
+		}
+		break;
+	case HTTPFSWriteOrder::THREADS: {
+		vector<ErrorData> errors(WRITE_THREADS);
+		vector<thread> threads;
+		for (idx_t t = 0; t < WRITE_THREADS; t++) {
+			threads.emplace_back([&, t]() {
+				try {
+					for (idx_t i = t; i < chunks.size(); i += WRITE_THREADS) {
+						write_chunk(chunks[i]);
+					}
+				} catch (std::exception &ex) {
+					errors[t] = ErrorData(ex);
+				}
+			});
+		}
+		for (auto &write_thread : threads) {
+			write_thread.join();
+		}
+		for (auto &error : errors) {
+			if (error.HasError()) {
+				error.Throw();
+			}
+		}
+		break;
+	}
+	case HTTPFSWriteOrder::GAP:
+		for (idx_t i = 0; i < chunks.size(); i++) {
+			if (i != chunks.size() / 2) {
+				write_chunk(chunks[i]);
+			}
+		}
+		break;
+	case HTTPFSWriteOrder::REWRITE:
+		for (auto &chunk : chunks) {
+			write_chunk(chunk);
+		}
+		write_chunk(chunks[0]);
+		break;
+	}
+
+	// The last row is appended at the offset of the handle, which is the end of the furthest write
+	auto data = GenerateRows(last_row, 1);
+	handle->Write(&data[0], data.size());
+	handle->Close();
+	result->bytes_written = bind_data.rows * WRITE_ROW_WIDTH;
+	return std::move(result);
+}
+
+static void HTTPFSWritePartsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<HTTPFSWritePartsState>();
+	if (state.finished) {
+		return;
+	}
+	output.SetValue(0, 0, Value::UBIGINT(state.bytes_written));
+	output.SetCardinality(1);
+	state.finished = true;
+}
+
+void HTTPFSInternalFunctions::Register(DatabaseInstance &instance) {
+	// Reads the given ranges of a file, one row per range, with the read path selected by `mode`. Internal: only used by
+	// the tests and the benchmarks
+	TableFunction read_ranges("__internal_httpfs_read_ranges",
+	                          {LogicalType::VARCHAR, LogicalType::LIST(LogicalType::UBIGINT),
+	                           LogicalType::LIST(LogicalType::UBIGINT)},
+	                          HTTPFSReadRangesFunction, HTTPFSReadRangesBind, HTTPFSReadRangesInit);
+	read_ranges.named_parameters["mode"] = LogicalType::VARCHAR;
+	ExtensionUtil::RegisterFunction(instance, read_ranges);
+
+	// Writes a file of `rows` numbered rows in chunks of `chunk_rows`, at their offsets and in the order selected by
+	// `order`, to test files that are not written front to back. Internal: only used by the tests
+	TableFunction write_parts("__internal_httpfs_write_parts",
+	                          {LogicalType::VARCHAR, LogicalType::UBIGINT, LogicalType::UBIGINT},
+	                          HTTPFSWritePartsFunction, HTTPFSWritePartsBind, HTTPFSWritePartsInit);
+	write_parts.named_parameters["order"] = LogicalType::VARCHAR;
+	ExtensionUtil::RegisterFunction(instance, write_parts);
+}
+
+} // namespace duckdb
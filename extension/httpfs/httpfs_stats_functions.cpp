@@ -0,0 +1,154 @@
+#include "httpfs_stats_functions.hpp"
+
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "http_state.hpp"
+#include "httpfs_client.hpp"
+
+namespace duckdb {
+
+struct HTTPFSQueryStatsState : public GlobalTableFunctionState {
+	vector<pair<HTTPOperation, HTTPOperationStatsSnapshot>> rows;
+	idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> HTTPFSQueryStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+	names.emplace_back("operation");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	for (auto &name :
+	     {"requests", "retries", "new_connections", "reused_connections", "bytes_sent", "bytes_received"}) {
+		names.emplace_back(name);
+		return_types.emplace_back(LogicalType::UBIGINT);
+	}
+	for (auto &name : {"bytes_per_request", "first_byte_p50_ms", "first_byte_p99_ms", "total_p50_ms", "total_p99_ms",
+	                   "total_time_ms"}) {
+		names.emplace_back(name);
+		return_types.emplace_back(LogicalType::DOUBLE);
+	}
+	return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> HTTPFSQueryStatsInit(ClientContext &context,
+                                                                 TableFunctionInitInput &input) {
+	auto result = make_uniq<HTTPFSQueryStatsState>();
+	auto state = HTTPState::TryGetState(context);
+	if (state) {
+		result->rows = state->GetLastQueryStats();
+	}
+	return std::move(result);
+}
+
+static Value MicrosToMillis(idx_t micros) {
+	return Value::DOUBLE(static_cast<double>(micros) / 1000);
+}
+
+static void HTTPFSQueryStatsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<HTTPFSQueryStatsState>();
+	idx_t count = 0;
+	while (state.offset < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = state.rows[state.offset++];
+		auto &stats = row.second;
+		idx_t col = 0;
+		output.SetValue(col++, count, Value(HTTPState::OperationToString(row.first)));
+		output.SetValue(col++, count, Value::UBIGINT(stats.request_count));
+		output.SetValue(col++, count, Value::UBIGINT(stats.retry_count));
+		output.SetValue(col++, count, Value::UBIGINT(stats.new_connection_count));
+		output.SetValue(col++, count, Value::UBIGINT(stats.reused_connection_count));
+		output.SetValue(col++, count, Value::UBIGINT(stats.bytes_sent));
+		output.SetValue(col++, count, Value::UBIGINT(stats.bytes_received));
+		output.SetValue(col++, count,
+		                Value::DOUBLE(static_cast<double>(stats.bytes_sent + stats.bytes_received) /
+		                              static_cast<double>(stats.request_count)));
+		output.SetValue(col++, count, MicrosToMillis(stats.ttfb_p50_micros));
+		output.SetValue(col++, count, MicrosToMillis(stats.ttfb_p99_micros));
+		output.SetValue(col++, count, MicrosToMillis(stats.total_p50_micros));
+		output.SetValue(col++, count, MicrosToMillis(stats.total_p99_micros));
+		output.SetValue(col++, count, MicrosToMillis(stats.total_micros));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+struct HTTPFSStatsBindData : public TableFunctionData {
+	bool reset = false;
+};
+
+struct HTTPFSStatsState : public GlobalTableFunctionState {
+	vector<pair<HTTPGlobalStatsKey, HTTPGlobalStatsEntry>> rows;
+	idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> HTTPFSStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                vector<LogicalType> &return_types, vector<string> &names) {
+	auto result = make_uniq<HTTPFSStatsBindData>();
+	for (auto &kv : input.named_parameters) {
+		if (kv.first == "reset") {
+			result->reset = BooleanValue::Get(kv.second);
+		}
+	}
+	names.emplace_back("host");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("operation");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("status");
+	return_types.emplace_back(LogicalType::USMALLINT);
+	for (auto &name :
+	     {"requests", "retries", "new_connections", "reused_connections", "bytes_sent", "bytes_received"}) {
+		names.emplace_back(name);
+		return_types.emplace_back(LogicalType::UBIGINT);
+	}
+	names.emplace_back("total_time_ms");
+	return_types.emplace_back(LogicalType::DOUBLE);
+	return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> HTTPFSStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<HTTPFSStatsBindData>();
+	auto result = make_uniq<HTTPFSStatsState>();
+	// Statistics are only gathered by the httplib based client
+	auto &http_util = DBConfig::GetConfig(context).http_util;
+	if (http_util && http_util->GetName() == "HTTPFS") {
+		auto &httpfs_util = static_cast<HTTPFSUtil &>(*http_util);
+		result->rows = httpfs_util.GetGlobalStats()->GetEntries(bind_data.reset);
+	}
+	return std::move(result);
+}
+
+static void HTTPFSStatsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<HTTPFSStatsState>();
+	idx_t count = 0;
+	while (state.offset < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &row = state.rows[state.offset++];
+		auto &key = row.first;
+		auto &stats = row.second;
+		idx_t col = 0;
+		output.SetValue(col++, count, Value(key.host));
+		output.SetValue(col++, count, Value(HTTPState::OperationToString(key.op)));
+		output.SetValue(col++, count, Value::USMALLINT(key.status));
+		output.SetValue(col++, count, Value::UBIGINT(stats.request_count));
+		output.SetValue(col++, count, Value::UBIGINT(stats.retry_count));
+		output.SetValue(col++, count, Value::UBIGINT(stats.new_connection_count));
+		output.SetValue(col++, count, Value::UBIGINT(stats.reused_connection_count));
+		output.SetValue(col++, count, Value::UBIGINT(stats.bytes_sent));
+		output.SetValue(col++, count, Value::UBIGINT(stats.bytes_received));
+		output.SetValue(col++, count, MicrosToMillis(stats.total_micros));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+void HTTPFSStatsFunctions::Register(DatabaseInstance &instance) {
+	// Statistics of the last query of this connection that sent HTTP requests, one row per operation
+	TableFunction query_stats("httpfs_query_stats", {}, HTTPFSQueryStatsFunction, HTTPFSQueryStatsBind,
+	                          HTTPFSQueryStatsInit);
+	ExtensionUtil::RegisterFunction(instance, query_stats);
+
+	// Cumulative statistics of all requests of the database, by host, operation and response status
+	TableFunction stats("httpfs_stats", {}, HTTPFSStatsFunction, HTTPFSStatsBind, HTTPFSStatsInit);
+	stats.named_parameters["reset"] = LogicalType::BOOLEAN;
+	ExtensionUtil::RegisterFunction(instance, stats);
+}
+
+} // namespace duckdb
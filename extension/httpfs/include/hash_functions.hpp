@@ -15,4 +15,15 @@ void hmac256(std::string message, hash_bytes secret, hash_bytes &out);
 
 void hex256(hash_bytes &in, hash_str &out);
 
+//! CRC-32C (Castagnoli) of `in`, continuing from `crc` (0 for a new checksum). Uses the SSE 4.2 or ARMv8 CRC
+//! instructions when available.
+uint32_t crc32c(uint32_t crc, const char *in, size_t in_len);
+
+//! CRC-64/NVME of `in`, continuing from `crc` (0 for a new checksum)
+uint64_t crc64nvme(uint64_t crc, const char *in, size_t in_len);
+
+//! Checksum of the concatenation of two blocks, given their checksums and the length of the second block
+uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2);
+uint64_t crc64nvme_combine(uint64_t crc1, uint64_t crc2, size_t len2);
+
 } // namespace duckdb
@@ -4,14 +4,31 @@
 
 namespace duckdb {
 
+class HFTreeListParser;
+class HFFileHandle;
+
+//! Where the `resolve` endpoint of the hub redirects reads of a file to
+struct HFResolvedUrl {
+	explicit HFResolvedUrl(const HTTPFSParams &params_p) : params(params_p) {
+	}
+
+	//! The redirect target, empty if the hub serves the file itself
+	string url;
+	//! Unix time at which the (signed) redirect target expires, 0 if unknown
+	int64_t expiry = 0;
+	//! Parameters and clients for requests to the redirect target, which must not carry the hub's bearer token
+	HTTPFSParams params;
+	HTTPClientCache clients;
+};
+
 struct ParsedHFUrl {
 	//! Path within the
 	string path;
 	//! Name of the repo (i presume)
 	string repository;
 
-	//! Endpoint, defaults to HF
-	string endpoint = "https://huggingface.co";
+	//! Endpoint, defaults to HF (see the `hf_endpoint` setting)
+	string endpoint = HTTPFSParams::DEFAULT_HF_ENDPOINT;
 	//! Which revision/branch/tag to use
 	string revision = "main";
 	//! For DuckDB this may be a sensible default?
@@ -29,6 +46,10 @@ public:
 	duckdb::unique_ptr<HTTPResponse> GetRangeRequest(FileHandle &handle, string hf_url, HTTPHeaders header_map,
 	                                                 idx_t file_offset, char *buffer_out,
 	                                                 idx_t buffer_out_len) override;
+	//! The hub and its CDN do not support requests for multiple ranges
+	bool SupportsMultiRangeRequests(FileHandle &handle) override {
+		return false;
+	}
 
 	bool CanHandleFile(const string &fpath) override {
 		return fpath.rfind("hf://", 0) == 0;
@@ -39,7 +60,7 @@ public:
 	}
 	static ParsedHFUrl HFUrlParse(const string &url);
 	string GetHFUrl(const ParsedHFUrl &url);
-	string GetTreeUrl(const ParsedHFUrl &url, idx_t limit);
+	string GetTreeUrl(const ParsedHFUrl &url, idx_t limit, bool recursive = false);
 	string GetFileUrl(const ParsedHFUrl &url);
 
 	static void SetParams(HTTPFSParams &params, const string &path, optional_ptr<FileOpener> opener);
@@ -48,8 +69,18 @@ protected:
 	duckdb::unique_ptr<HTTPFileHandle> CreateHandle(const OpenFileInfo &file, FileOpenFlags flags,
 	                                                optional_ptr<FileOpener> opener) override;
 
-	string ListHFRequest(ParsedHFUrl &url, HTTPFSParams &http_params, string &next_page_url,
-	                     optional_ptr<HTTPState> state);
+	//! Returns where range reads of the handle should go to: the cached target of the `resolve` redirect if it has not
+	//! expired, resolving it first if needed. Returns nullptr if the hub could not be asked.
+	shared_ptr<HFResolvedUrl> GetResolvedUrl(HFFileHandle &handle);
+	//! Drops the cached redirect target (if it is still `resolved`), e.g. when the CDN rejected it
+	void InvalidateResolvedUrl(HFFileHandle &handle, const shared_ptr<HFResolvedUrl> &resolved);
+
+	//! Signed redirect targets are resolved again this many seconds before they expire
+	static constexpr int64_t REDIRECT_EXPIRY_MARGIN = 60;
+
+	//! Fetches one page of a tree listing into `parser`, and sets `next_page_url` to the next page (if any)
+	void ListHFRequest(ParsedHFUrl &url, HTTPFSParams &http_params, string &next_page_url, HFTreeListParser &parser,
+	                   optional_ptr<HTTPState> state);
 };
 
 class HFFileHandle : public HTTPFileHandle {
@@ -57,15 +88,17 @@ class HFFileHandle : public HTTPFileHandle {
 
 public:
 	HFFileHandle(FileSystem &fs, ParsedHFUrl hf_url, const OpenFileInfo &file, FileOpenFlags flags,
-	             unique_ptr<HTTPParams> http_params)
-	    : HTTPFileHandle(fs, file, flags, std::move(http_params)), parsed_url(std::move(hf_url)) {
-	}
+	             unique_ptr<HTTPParams> http_params);
 	~HFFileHandle() override;
 
 	unique_ptr<HTTPClient> CreateClient() override;
 
 protected:
 	ParsedHFUrl parsed_url;
+
+	//! Cached target of the redirect of the `resolve` endpoint, nullptr if not resolved (yet)
+	mutex redirect_lock;
+	shared_ptr<HFResolvedUrl> resolved_url;
 };
 
 } // namespace duckdb
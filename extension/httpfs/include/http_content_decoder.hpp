@@ -0,0 +1,30 @@
+#pragma once
+
+#include "duckdb/common/common.hpp"
+
+#include <functional>
+
+namespace duckdb {
+
+//! Decodes a response body that was sent with a Content-Encoding while it arrives, so that compressed downloads can be
+//! written to their destination without buffering the compressed body first
+class HTTPContentDecoder {
+public:
+	typedef std::function<void(const_data_ptr_t data, idx_t length)> sink_t;
+
+	//! Value of the Accept-Encoding header that requests one of the encodings that can be decoded
+	static constexpr const char *ACCEPT_ENCODING = "zstd, gzip";
+
+	virtual ~HTTPContentDecoder() = default;
+
+	//! Creates a decoder for a Content-Encoding header value, nullptr if the body is not encoded. Throws for encodings
+	//! that cannot be decoded.
+	static unique_ptr<HTTPContentDecoder> Create(const string &url, const string &content_encoding);
+
+	//! Decodes the next part of the body, passing the decoded bytes to `sink`
+	virtual void Decode(const_data_ptr_t data, idx_t length, const sink_t &sink) = 0;
+	//! Called once the whole body was received, throws if it was truncated
+	virtual void Finish() = 0;
+};
+
+} // namespace duckdb
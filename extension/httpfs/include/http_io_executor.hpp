@@ -0,0 +1,89 @@
+#pragma once
+
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/pair.hpp"
+#include "duckdb/common/thread.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+
+namespace duckdb {
+
+//! Threads that run blocking HTTP requests on behalf of httpfs: the concurrent requests of multi-range reads, directory
+//! listings, connection pre-warming and hedged requests. Threads are started on demand up to a maximum and are kept
+//! for reuse, so fanning out requests does not start a thread per request, and the number of threads waiting on the
+//! network is bounded for the whole database rather than per call.
+//! The requests themselves are still blocking: each one occupies a thread of the executor until it completes, so at
+//! most `max_threads` requests are in flight. A non-blocking, event-driven client that multiplexes many requests over
+//! a few threads is not implemented (it would need a new HTTP and TLS stack instead of cpp-httplib).
+class HTTPIOExecutor {
+public:
+	explicit HTTPIOExecutor(idx_t max_threads);
+	~HTTPIOExecutor();
+
+	//! Queues a task, starting a thread if none is idle and the maximum has not been reached. A task must not wait for
+	//! other tasks of the executor, which may be queued behind it. If the executor is destroyed before the task got to
+	//! run, `cancel` is called instead, so that whoever waits for the task can be told.
+	void Schedule(std::function<void()> task, std::function<void()> cancel = nullptr);
+	//! Queues a task only if it can start right away. For tasks that others wait for while occupying a thread of the
+	//! executor (such as hedged attempts), which must not be queued behind their waiters.
+	bool TrySchedule(std::function<void()> task, std::function<void()> cancel = nullptr);
+	//! Changes the maximum number of threads; excess threads are not stopped, but no new ones are started
+	void SetMaxThreads(idx_t max_threads);
+	//! Number of threads that have been started
+	idx_t ThreadCount();
+
+private:
+	struct Task {
+		std::function<void()> run;
+		std::function<void()> cancel;
+	};
+
+	//! Queues a task and starts a thread if needed and allowed, requires the lock to be held
+	void ScheduleInternal(Task task);
+	void WorkerLoop();
+
+	mutex lock;
+	std::condition_variable task_available;
+	std::deque<Task> tasks;
+	vector<thread> threads;
+	idx_t idle_threads = 0;
+	idx_t max_threads;
+	bool shutdown = false;
+};
+
+//! Collects the completions of asynchronous reads (see HTTPFileSystem::ReadAsync), identified by the tag they were
+//! started with. Destroying the queue waits for the reads that are still in flight, so their buffers stay valid.
+class HTTPCompletionQueue {
+public:
+	HTTPCompletionQueue() = default;
+	~HTTPCompletionQueue();
+
+	//! Waits for the next read to complete and sets `tag` to its tag, rethrowing its error if it failed. Returns false
+	//! if there is nothing left to wait for.
+	bool Next(idx_t &tag);
+	//! Like Next, but returns false without waiting if no read has completed yet
+	bool TryNext(idx_t &tag);
+	//! Waits for all outstanding reads, rethrowing the first error
+	void WaitAll();
+	//! Number of reads that were started but have not been returned by Next yet
+	idx_t Outstanding();
+
+	//! Called by the producer when a read is started and when it is done
+	void Start();
+	void Complete(idx_t tag, ErrorData error = ErrorData());
+
+private:
+	//! Pops the next completion, requires the lock to be held and a completion to be available
+	idx_t PopCompletion(unique_lock<mutex> &guard);
+
+	mutex lock;
+	std::condition_variable completion;
+	std::deque<pair<idx_t, ErrorData>> completed;
+	idx_t in_flight = 0;
+};
+
+} // namespace duckdb
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/types.hpp"
+
+namespace duckdb {
+
+//! Lock-free latency histogram with logarithmic buckets: every power of two (in microseconds) is split into
+//! SUB_BUCKETS linear buckets, which keeps the relative error of a reported percentile below 1 / SUB_BUCKETS
+class HTTPLatencyHistogram {
+public:
+	static constexpr idx_t SUB_BUCKET_BITS = 2;
+	static constexpr idx_t SUB_BUCKETS = idx_t(1) << SUB_BUCKET_BITS;
+	//! 2^40 microseconds is ~12 days, anything slower ends up in the last bucket
+	static constexpr idx_t MAX_EXPONENT = 40;
+	static constexpr idx_t BUCKET_COUNT = (MAX_EXPONENT + 1) * SUB_BUCKETS;
+
+	void Record(idx_t micros) {
+		buckets[GetBucket(micros)]++;
+		total_micros += micros;
+		count++;
+	}
+
+	void Reset() {
+		for (auto &bucket : buckets) {
+			bucket = 0;
+		}
+		total_micros = 0;
+		count = 0;
+	}
+
+	idx_t Count() const {
+		return count;
+	}
+
+	idx_t TotalMicros() const {
+		return total_micros;
+	}
+
+	//! Returns the upper bound (in microseconds) of the bucket containing the given percentile (0 < percentile <= 1)
+	idx_t Percentile(double percentile) const {
+		idx_t total = count;
+		if (total == 0) {
+			return 0;
+		}
+		auto target = static_cast<idx_t>(percentile * static_cast<double>(total));
+		if (target == 0) {
+			target = 1;
+		}
+		idx_t seen = 0;
+		for (idx_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+			seen += buckets[bucket];
+			if (seen >= target) {
+				return GetBucketUpperBound(bucket);
+			}
+		}
+		return GetBucketUpperBound(BUCKET_COUNT - 1);
+	}
+
+private:
+	static idx_t GetBucket(idx_t micros) {
+		if (micros < SUB_BUCKETS) {
+			return micros;
+		}
+		// position of the highest set bit
+		idx_t exponent = 0;
+		for (idx_t value = micros; value > 1; value >>= 1) {
+			exponent++;
+		}
+		if (exponent > MAX_EXPONENT) {
+			return BUCKET_COUNT - 1;
+		}
+		auto sub_bucket = (micros >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+		return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub_bucket;
+	}
+
+	static idx_t GetBucketUpperBound(idx_t bucket) {
+		if (bucket < SUB_BUCKETS) {
+			return bucket + 1;
+		}
+		auto exponent = bucket / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+		auto sub_bucket = bucket % SUB_BUCKETS;
+		auto bucket_width = idx_t(1) << (exponent - SUB_BUCKET_BITS);
+		return (idx_t(1) << exponent) + (sub_bucket + 1) * bucket_width;
+	}
+
+	atomic<idx_t> buckets[BUCKET_COUNT] = {};
+	atomic<idx_t> total_micros {0};
+	atomic<idx_t> count {0};
+};
+
+} // namespace duckdb
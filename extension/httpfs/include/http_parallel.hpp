@@ -0,0 +1,112 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/thread.hpp"
+#include "duckdb/common/vector.hpp"
+#include "http_io_executor.hpp"
+
+#include <condition_variable>
+#include <functional>
+
+namespace duckdb {
+
+//! State of an HTTPParallelFor call, shared with its helpers: a helper that is scheduled on the executor may only start
+//! running after the call has returned.
+struct HTTPParallelForState {
+	HTTPParallelForState(idx_t count, const std::function<void(idx_t)> &task) : count(count), task(task) {
+	}
+
+	idx_t count;
+	//! Only valid until `closed` is set
+	const std::function<void(idx_t)> &task;
+	atomic<idx_t> next_task {0};
+	atomic<bool> failed {false};
+
+	mutex lock;
+	std::condition_variable helper_finished;
+	ErrorData error;
+	//! Set once the caller stopped waiting for helpers that have not started yet
+	bool closed = false;
+	idx_t active_helpers = 0;
+
+	void Work() {
+		while (!failed) {
+			auto i = next_task++;
+			if (i >= count) {
+				return;
+			}
+			try {
+				task(i);
+			} catch (std::exception &ex) {
+				lock_guard<mutex> guard(lock);
+				if (!failed) {
+					error = ErrorData(ex);
+					failed = true;
+				}
+			}
+		}
+	}
+
+	static void RunHelper(const shared_ptr<HTTPParallelForState> &state) {
+		{
+			lock_guard<mutex> guard(state->lock);
+			if (state->closed) {
+				return;
+			}
+			state->active_helpers++;
+		}
+		state->Work();
+		{
+			lock_guard<mutex> guard(state->lock);
+			state->active_helpers--;
+		}
+		state->helper_finished.notify_all();
+	}
+};
+
+//! Runs `task(i)` for every i in [0, count) using at most `max_concurrency` threads, the calling thread included.
+//! Intended for fanning out blocking HTTP requests: the helper threads come from `executor` if given, otherwise they
+//! are started for this call. The calling thread works through the tasks itself, so it never waits for helpers that
+//! did not get to run because the executor is busy. The first exception thrown by a task is rethrown once all helpers
+//! have finished; remaining tasks are skipped after a failure.
+static inline void HTTPParallelFor(optional_ptr<HTTPIOExecutor> executor, idx_t count, idx_t max_concurrency,
+                                   const std::function<void(idx_t)> &task) {
+	if (count == 0) {
+		return;
+	}
+	auto thread_count = MinValue<idx_t>(MaxValue<idx_t>(max_concurrency, 1), count);
+	if (thread_count == 1) {
+		for (idx_t i = 0; i < count; i++) {
+			task(i);
+		}
+		return;
+	}
+
+	auto state = make_shared_ptr<HTTPParallelForState>(count, task);
+	vector<thread> threads;
+	for (idx_t i = 1; i < thread_count; i++) {
+		if (executor) {
+			executor->Schedule([state]() { HTTPParallelForState::RunHelper(state); });
+		} else {
+			threads.emplace_back(HTTPParallelForState::RunHelper, state);
+		}
+	}
+	state->Work();
+	{
+		unique_lock<mutex> guard(state->lock);
+		state->closed = true;
+		state->helper_finished.wait(guard, [&]() { return state->active_helpers == 0; });
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+	if (state->failed) {
+		state->error.Throw();
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "duckdb/main/secret/secret_manager.hpp"
+
+namespace duckdb {
+
+//! Per-query cache of parameters that were resolved from settings and secrets, which is cleared when the query ends.
+//! Settings cannot change while a query runs, so the resolved parameters only depend on which secrets match the path
+//! of a file: entries are keyed by TryGetSecretMatchKey.
+template <class T>
+class HTTPParamsCache : public ClientContextState {
+public:
+	//! Returns the cache of the client of `opener`, nullptr if there is no client (and hence no query)
+	static shared_ptr<HTTPParamsCache<T>> TryGetCache(optional_ptr<FileOpener> opener, const string &name) {
+		auto context = FileOpener::TryGetClientContext(opener);
+		if (!context) {
+			return nullptr;
+		}
+		return context->registered_state->GetOrCreate<HTTPParamsCache<T>>(name);
+	}
+
+	//! Returns a copy of the cached parameters, nullptr if there are none
+	unique_ptr<T> TryGet(const string &key) {
+		lock_guard<mutex> guard(lock);
+		auto entry = entries.find(key);
+		if (entry == entries.end()) {
+			return nullptr;
+		}
+		return make_uniq<T>(*entry->second);
+	}
+
+	void Insert(const string &key, const T &params) {
+		lock_guard<mutex> guard(lock);
+		entries[key] = make_uniq<T>(params);
+	}
+
+	void Clear() {
+		lock_guard<mutex> guard(lock);
+		entries.clear();
+		secret_scopes.clear();
+		secret_matches.clear();
+	}
+
+	void QueryEnd(ClientContext &context) override {
+		Clear();
+	}
+
+	//! Identifies the secrets of the given types that match `path`. Returns false if secrets cannot be looked up.
+	//! Which secret of a type matches a path only depends on the longest scope of that type the path starts with, so
+	//! the secret manager is asked once per such scope (e.g. once per bucket) rather than once per file.
+	bool TryGetSecretMatchKey(optional_ptr<FileOpener> opener, const string &path, const char **secret_types,
+	                          idx_t secret_types_len, string &result) {
+		auto secret_manager = FileOpener::TryGetSecretManager(opener);
+		auto transaction = FileOpener::TryGetCatalogTransaction(opener);
+		if (!secret_manager || !transaction) {
+			return false;
+		}
+		result.clear();
+		for (idx_t i = 0; i < secret_types_len; i++) {
+			string secret_type = secret_types[i];
+			auto scope = GetLongestMatchingScope(*secret_manager, *transaction, secret_type, path);
+			auto match_key = secret_type + "|" + scope;
+			string match;
+			if (!TryGetSecretMatch(match_key, match)) {
+				auto secret_match = secret_manager->LookupSecret(*transaction, path, secret_type);
+				if (secret_match.HasMatch()) {
+					auto &entry = *secret_match.secret_entry;
+					match = entry.storage_mode + "." + entry.secret->GetName();
+				}
+				lock_guard<mutex> guard(lock);
+				secret_matches[match_key] = match;
+			}
+			result += match;
+			result += "|";
+		}
+		return true;
+	}
+
+private:
+	//! Returns the longest scope of the secrets of `secret_type` that `path` starts with (or "" if there is none),
+	//! which is what the secret manager matches secrets by
+	string GetLongestMatchingScope(SecretManager &secret_manager, CatalogTransaction &transaction,
+	                               const string &secret_type, const string &path) {
+		vector<string> scopes;
+		{
+			lock_guard<mutex> guard(lock);
+			auto entry = secret_scopes.find(secret_type);
+			if (entry != secret_scopes.end()) {
+				scopes = entry->second;
+			}
+		}
+		if (scopes.empty()) {
+			for (auto &secret_entry : secret_manager.AllSecrets(transaction)) {
+				if (!StringUtil::CIEquals(secret_entry.secret->GetType(), secret_type)) {
+					continue;
+				}
+				for (auto &scope : secret_entry.secret->GetScope()) {
+					scopes.push_back(scope);
+				}
+			}
+			// an empty scope matches any path, so a type without secrets still gets an entry
+			scopes.emplace_back();
+			lock_guard<mutex> guard(lock);
+			secret_scopes[secret_type] = scopes;
+		}
+		const string *longest_scope = nullptr;
+		for (auto &scope : scopes) {
+			if (StringUtil::StartsWith(path, scope) && (!longest_scope || scope.size() > longest_scope->size())) {
+				longest_scope = &scope;
+			}
+		}
+		return *longest_scope;
+	}
+
+	bool TryGetSecretMatch(const string &match_key, string &result) {
+		lock_guard<mutex> guard(lock);
+		auto entry = secret_matches.find(match_key);
+		if (entry == secret_matches.end()) {
+			return false;
+		}
+		result = entry->second;
+		return true;
+	}
+
+	mutex lock;
+	unordered_map<string, unique_ptr<T>> entries;
+	//! Scopes of the secrets of each type, as of the first lookup of the query
+	unordered_map<string, vector<string>> secret_scopes;
+	//! Secret that matches, keyed by secret type and longest matching scope
+	unordered_map<string, string> secret_matches;
+};
+
+} // namespace duckdb
@@ -4,8 +4,10 @@
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/client_data.hpp"
 #include "duckdb/common/atomic.hpp"
+#include "duckdb/common/map.hpp"
 #include "duckdb/common/optional_ptr.hpp"
 #include "duckdb/main/client_context_state.hpp"
+#include "http_latency_histogram.hpp"
 
 namespace duckdb {
 
@@ -68,6 +70,86 @@ private:
 	shared_ptr<CachedFile> file;
 };
 
+//! The HTTP operations that request statistics are kept for
+enum class HTTPOperation : uint8_t { HEAD_OP, GET_OP, PUT_OP, POST_OP, DELETE_OP };
+static constexpr idx_t HTTP_OPERATION_COUNT = 5;
+
+//! Statistics of the requests of one HTTP operation. Every attempt counts as a request, including retries.
+struct HTTPOperationStats {
+	atomic<idx_t> request_count {0};
+	//! Retries that were sent: attempts of a request whose previous attempt failed with a connection error or with a
+	//! 408, 429 or 5xx response
+	atomic<idx_t> retry_count {0};
+	//! Requests that had to open a new connection, and requests sent over an already open connection
+	atomic<idx_t> new_connection_count {0};
+	atomic<idx_t> reused_connection_count {0};
+	atomic<idx_t> bytes_sent {0};
+	atomic<idx_t> bytes_received {0};
+	//! Time until the response headers arrived, and until the response was read completely
+	HTTPLatencyHistogram time_to_first_byte;
+	HTTPLatencyHistogram total_time;
+
+	void Reset();
+};
+
+//! Plain copy of the HTTPOperationStats of a single operation
+struct HTTPOperationStatsSnapshot {
+	idx_t request_count = 0;
+	idx_t retry_count = 0;
+	idx_t new_connection_count = 0;
+	idx_t reused_connection_count = 0;
+	idx_t bytes_sent = 0;
+	idx_t bytes_received = 0;
+	idx_t ttfb_p50_micros = 0;
+	idx_t ttfb_p99_micros = 0;
+	idx_t total_p50_micros = 0;
+	idx_t total_p99_micros = 0;
+	idx_t total_micros = 0;
+};
+
+//! Totals of the requests to one host with one operation and response status in HTTPGlobalStats
+struct HTTPGlobalStatsEntry {
+	idx_t request_count = 0;
+	idx_t retry_count = 0;
+	idx_t new_connection_count = 0;
+	idx_t reused_connection_count = 0;
+	idx_t bytes_sent = 0;
+	idx_t bytes_received = 0;
+	idx_t total_micros = 0;
+
+	void Add(const HTTPGlobalStatsEntry &other);
+};
+
+struct HTTPGlobalStatsKey {
+	string host;
+	HTTPOperation op;
+	//! The response status, 0 for requests that failed without a response
+	uint16_t status;
+
+	bool operator<(const HTTPGlobalStatsKey &other) const {
+		if (host != other.host) {
+			return host < other.host;
+		}
+		if (op != other.op) {
+			return op < other.op;
+		}
+		return status < other.status;
+	}
+};
+
+//! Cumulative statistics of all requests of a database, by host, operation and response status. Unlike the
+//! statistics in HTTPState these are not reset when a query ends, only on request (see `httpfs_stats`).
+class HTTPGlobalStats {
+public:
+	void Record(const HTTPGlobalStatsKey &key, const HTTPGlobalStatsEntry &request);
+	//! Returns the statistics gathered so far, and optionally starts over
+	vector<pair<HTTPGlobalStatsKey, HTTPGlobalStatsEntry>> GetEntries(bool reset);
+
+private:
+	mutex lock;
+	map<HTTPGlobalStatsKey, HTTPGlobalStatsEntry> entries;
+};
+
 class HTTPState : public ClientContextState {
 public:
 	//! Reset all counters and cached files
@@ -80,7 +162,7 @@ public:
 
 	bool IsEmpty() {
 		return head_count == 0 && get_count == 0 && put_count == 0 && post_count == 0 && delete_count == 0 &&
-		       total_bytes_received == 0 && total_bytes_sent == 0;
+		       total_bytes_received == 0 && total_bytes_sent == 0 && hedged_request_count == 0;
 	}
 
 	atomic<idx_t> head_count {0};
@@ -90,18 +172,31 @@ public:
 	atomic<idx_t> delete_count {0};
 	atomic<idx_t> total_bytes_received {0};
 	atomic<idx_t> total_bytes_sent {0};
+	atomic<idx_t> hedged_request_count {0};
 
-	//! Called by the ClientContext when the current query ends
-	void QueryEnd(ClientContext &context) override {
-		Reset();
+	//! Request statistics per HTTPOperation
+	HTTPOperationStats operation_stats[HTTP_OPERATION_COUNT];
+
+	HTTPOperationStats &GetOperationStats(HTTPOperation op) {
+		return operation_stats[static_cast<idx_t>(op)];
 	}
+	static string OperationToString(HTTPOperation op);
+
+	//! Called by the ClientContext when the current query ends
+	void QueryEnd(ClientContext &context) override;
 	void WriteProfilingInformation(std::ostream &ss) override;
 
+	//! Per-operation statistics of the last query of this connection that sent HTTP requests
+	vector<pair<HTTPOperation, HTTPOperationStatsSnapshot>> GetLastQueryStats();
+
 private:
 	//! Mutex to lock when getting the cached file(Parallel Only)
 	mutex cached_files_mutex;
 	//! In case of fully downloading the file, the cached files of this query
 	unordered_map<string, shared_ptr<CachedFile>> cached_files;
+	//! Statistics of the last query that sent HTTP requests, kept beyond QueryEnd
+	mutex last_query_lock;
+	vector<pair<HTTPOperation, HTTPOperationStatsSnapshot>> last_query_stats;
 };
 
 } // namespace duckdb
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/thread.hpp"
+#include "httpfs_client.hpp"
+
+#include <condition_variable>
+#include <deque>
+
+namespace duckdb {
+
+//! Upload of a file that is written sequentially over plain HTTP(S). The file is sent in a single PUT or POST request
+//! with chunked transfer encoding while it is being written, so its size does not need to be known up-front. The
+//! request runs on its own thread; at most `buffer_size` bytes are buffered between the writer and the request, and
+//! writes block while the buffer is full.
+class HTTPStreamingUpload {
+public:
+	HTTPStreamingUpload(HTTPFSUtil &http_util, HTTPFSParams &params, string url, HTTPHeaders headers);
+	//! Aborts the upload if it was not finished
+	~HTTPStreamingUpload();
+
+	void Write(const_data_ptr_t data, idx_t length);
+	//! Completes the body and waits for the response, throwing if the upload failed
+	void Finish();
+
+private:
+	//! Hands `current_chunk` to the request, waiting for space in the buffer
+	void PushChunk();
+	//! Body source of the request
+	bool NextChunk(string &chunk);
+	void RunRequest();
+	//! Throws if the request failed, which must have ended
+	void ThrowRequestError();
+
+	HTTPFSUtil &http_util;
+	HTTPFSParams &params;
+	string url;
+	HTTPHeaders headers;
+	idx_t chunk_size;
+	idx_t buffer_size;
+
+	//! Data that was written but not yet handed to the request, only accessed by the writer
+	string current_chunk;
+
+	mutex lock;
+	std::condition_variable chunk_available;
+	std::condition_variable space_available;
+	std::deque<string> chunks;
+	idx_t buffered_bytes = 0;
+	bool body_complete = false;
+	bool aborted = false;
+	//! Set once the request returned, successfully or not
+	bool request_done = false;
+	unique_ptr<HTTPResponse> response;
+	ErrorData error;
+	thread request_thread;
+};
+
+} // namespace duckdb
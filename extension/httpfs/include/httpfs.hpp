@@ -7,7 +7,10 @@
 #include "duckdb/common/unordered_map.hpp"
 #include "duckdb/common/exception/http_exception.hpp"
 #include "duckdb/main/client_data.hpp"
+#include "http_io_executor.hpp"
+#include "http_latency_histogram.hpp"
 #include "http_metadata_cache.hpp"
+#include "http_streaming_upload.hpp"
 #include "httpfs_client.hpp"
 
 #include <mutex>
@@ -30,7 +33,30 @@ protected:
 
 class HTTPFileSystem;
 
+//! A range of a file to read into `buffer`
+struct HTTPFileRange {
+	idx_t offset;
+	idx_t length;
+	data_ptr_t buffer;
+};
+
+//! Sees the body of a full download as it was sent, i.e. before its Content-Encoding (if any) is decoded
+class HTTPRawBodyObserver {
+public:
+	virtual ~HTTPRawBodyObserver() = default;
+
+	//! Called before the body of every attempt (a retried request receives the whole body again). `decoded` is set if
+	//! the body is decoded before it is stored in the file handle.
+	virtual void Start(bool decoded) = 0;
+	virtual void Write(const_data_ptr_t data, idx_t length) = 0;
+};
+
+//! Whether the server of a file answers a request for multiple ranges with a multipart/byteranges response
+enum class MultiRangeSupport : uint8_t { UNKNOWN, SUPPORTED, UNSUPPORTED };
+
 class HTTPFileHandle : public FileHandle {
+	friend class HTTPFileSystem;
+
 public:
 	HTTPFileHandle(FileSystem &fs, const OpenFileInfo &file, FileOpenFlags flags, unique_ptr<HTTPParams> params);
 	~HTTPFileHandle() override;
@@ -46,10 +72,12 @@ public:
 	// File handle info
 	FileOpenFlags flags;
 	idx_t length;
-	time_t last_modified;
+	time_t last_modified = 0;
 	string etag;
 	bool force_full_download;
 	bool initialized = false;
+	// Set while the file info is loaded with a range GET: a 404 is then returned by GetRangeRequest instead of thrown
+	bool probing_file_info = false;
 
 	// When using full file download, the full file will be written to a cached file handle
 	unique_ptr<CachedFileHandle> cached_file_handle;
@@ -68,6 +96,21 @@ public:
 	duckdb::unique_ptr<data_t[]> read_buffer;
 	constexpr static idx_t READ_BUFFER_LEN = 1000000;
 
+	// Learned from the first multi-range request
+	atomic<MultiRangeSupport> multi_range_support {MultiRangeSupport::UNKNOWN};
+
+	// Tail of the file, fetched by the first read that falls into it (see `http_tail_prefetch_size`) and read-only
+	// once `tail_fetched` is set
+	mutex tail_lock;
+	atomic<bool> tail_fetched {false};
+	unsafe_unique_array<data_t> tail_buffer;
+	idx_t tail_start = 0;
+	idx_t tail_length = 0;
+
+	// Write info: the upload is started by the first write, and completed when the file is synced or closed
+	unique_ptr<HTTPStreamingUpload> upload;
+	bool upload_finished = false;
+
 	void AddHeaders(HTTPHeaders &map);
 
 	// Get a Client to run requests over
@@ -76,14 +119,27 @@ public:
 	void StoreClient(unique_ptr<HTTPClient> client);
 
 public:
-	void Close() override {
-	}
+	void Close() override;
 
 protected:
 	//! Create a new Client
 	virtual unique_ptr<HTTPClient> CreateClient();
 	//! Perform a HEAD request to get the file info (if not yet loaded)
 	void LoadFileInfo();
+	//! Load the file info with a range GET of the first `probe_read_size` bytes instead of a HEAD request, keeping the
+	//! bytes in the read buffer. Returns false if the server did not answer with a usable partial response.
+	bool TryProbeFileInfo();
+	//! Number of bytes at the end of the file that are fetched at once when they are first read, 0 if disabled
+	idx_t GetTailPrefetchSize();
+	//! Fetch the last `tail_size` bytes of the file into `tail_buffer`, logging (but otherwise ignoring) failures
+	void PrefetchTail(idx_t tail_size);
+	//! Serve a read from `tail_buffer` if it covers the requested range entirely, fetching the tail first if this is
+	//! the first read that falls into it
+	bool TryReadFromTail(void *buffer, idx_t nr_bytes, idx_t location);
+	//! Get the upload of a file opened for writing, starting it if needed
+	HTTPStreamingUpload &GetUpload();
+	//! Complete the upload of a file opened for writing (uploading an empty file if nothing was written)
+	void FinishUpload();
 
 private:
 	//! Fully downloads a file
@@ -114,6 +170,26 @@ public:
 
 	virtual duckdb::unique_ptr<HTTPResponse> DeleteRequest(FileHandle &handle, string url, HTTPHeaders header_map);
 
+	//! Reads multiple ranges of a file. If the server supports it, the ranges are requested together in
+	//! multipart/byteranges requests, otherwise (or if that fails) they are fetched concurrently one range at a time.
+	virtual void ReadRanges(FileHandle &handle, vector<HTTPFileRange> &ranges);
+	//! Vectored read: reads all (possibly overlapping) ranges of the file as a batch. Ranges are served from memory
+	//! where possible, ranges that are at most `http_read_coalesce_gap` apart are merged into a single read, and the
+	//! resulting reads are fetched together through ReadRanges.
+	void ReadV(FileHandle &handle, const vector<HTTPFileRange> &ranges);
+	//! Upper bound on the size of a read that ReadV merges from multiple ranges
+	static constexpr idx_t MAX_COALESCED_READ_SIZE = 16ULL * 1024 * 1024;
+	//! Starts reading `nr_bytes` at `location` into `buffer` and returns right away. The read runs on the I/O executor
+	//! of the database (see `http_io_threads`) and is reported on `queue` with `tag` once it is done, so the caller
+	//! can overlap I/O with other work. `buffer` and the handle must stay valid until then. Reads that can be served
+	//! from memory complete immediately; the position of the handle is not changed.
+	void ReadAsync(FileHandle &handle, void *buffer, idx_t nr_bytes, idx_t location, HTTPCompletionQueue &queue,
+	               idx_t tag);
+	//! Whether requests for multiple ranges may be sent for the file at all
+	virtual bool SupportsMultiRangeRequests(FileHandle &handle) {
+		return true;
+	}
+
 	// FS methods
 	void Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) override;
 	int64_t Read(FileHandle &handle, void *buffer, int64_t nr_bytes) override;
@@ -145,6 +221,14 @@ public:
 	static void Verify();
 
 	optional_ptr<HTTPMetadataCache> GetGlobalCache();
+	//! Latency until the first byte of range requests to the given host arrived, drives request hedging. Shared, as
+	//! hedged attempts that lose the race may still record into it after the file system is gone.
+	shared_ptr<HTTPLatencyHistogram> GetHostLatency(const string &proto_host_port);
+
+	//! Number of range requests to a host that need to be observed before requests to it are hedged
+	static constexpr idx_t MIN_HEDGE_SAMPLES = 32;
+	//! Lower bound of the hedging delay, to avoid duplicating requests to hosts that answer from a cache
+	static constexpr idx_t MIN_HEDGE_DELAY_MICROS = 1000;
 
 protected:
 	unique_ptr<FileHandle> OpenFileExtended(const OpenFileInfo &file, FileOpenFlags flags,
@@ -155,6 +239,22 @@ protected:
 
 	virtual HTTPException GetHTTPError(FileHandle &, const HTTPResponse &response, const string &url);
 
+	//! Single request for all (sorted, non-overlapping) `ranges`, parsed straight into their buffers. Returns false if
+	//! the server did not answer with the requested ranges, in which case the buffers may have been partially written.
+	bool GetMultiRangeRequest(FileHandle &handle, const string &url, HTTPHeaders header_map,
+	                          vector<HTTPFileRange> &ranges);
+
+	//! Range request for `hfh` that is sent with the given parameters and, if `client_cache` is set, over clients from
+	//! that cache rather than the handle's own. Used to send reads of a handle to a different host.
+	duckdb::unique_ptr<HTTPResponse> GetRangeRequest(HTTPFileHandle &hfh, HTTPFSParams &params,
+	                                                 optional_ptr<HTTPClientCache> client_cache, const string &url,
+	                                                 HTTPHeaders header_map, idx_t file_offset, char *buffer_out,
+	                                                 idx_t buffer_out_len);
+
+	//! Full download that passes the body, as it was received, to `raw_body_observer` as well
+	duckdb::unique_ptr<HTTPResponse> GetRequest(FileHandle &handle, const string &url, HTTPHeaders header_map,
+	                                            optional_ptr<HTTPRawBodyObserver> raw_body_observer);
+
 protected:
 	virtual duckdb::unique_ptr<HTTPFileHandle> CreateHandle(const OpenFileInfo &file, FileOpenFlags flags,
 	                                                        optional_ptr<FileOpener> opener);
@@ -163,6 +263,10 @@ private:
 	// Global cache
 	mutex global_cache_lock;
 	duckdb::unique_ptr<HTTPMetadataCache> global_metadata_cache;
+
+	// Per-host range request latencies
+	mutex host_latency_lock;
+	unordered_map<string, shared_ptr<HTTPLatencyHistogram>> host_latencies;
 };
 
 } // namespace duckdb
@@ -1,12 +1,20 @@
 #pragma once
 
 #include "duckdb/common/http_util.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/optional_ptr.hpp"
+
+#include <functional>
 
 namespace duckdb {
 class HTTPLogger;
 class FileOpener;
 struct FileOpenerInfo;
 class HTTPState;
+class HTTPFSConnectionPool;
+class HTTPFSConcurrencyLimiter;
+class HTTPGlobalStats;
+class HTTPIOExecutor;
 
 struct HTTPFSParams : public HTTPParams {
 	HTTPFSParams(HTTPUtil &http_util) : HTTPParams(http_util) {
@@ -14,16 +22,96 @@ struct HTTPFSParams : public HTTPParams {
 
 	static constexpr bool DEFAULT_ENABLE_SERVER_CERT_VERIFICATION = false;
 	static constexpr uint64_t DEFAULT_HF_MAX_PER_PAGE = 0;
+	static constexpr uint64_t DEFAULT_HF_MAX_CONCURRENT_LISTINGS = 8;
+	static constexpr bool DEFAULT_HF_CACHE_REDIRECTS = true;
+	static constexpr const char *DEFAULT_HF_ENDPOINT = "https://huggingface.co";
 	static constexpr bool DEFAULT_FORCE_DOWNLOAD = false;
+	static constexpr uint64_t DEFAULT_CONNECTION_POOL_SIZE = 8;
+	static constexpr uint64_t DEFAULT_PREWARM_CONNECTIONS = 0;
+	static constexpr uint64_t DEFAULT_TAIL_PREFETCH_SIZE = 0;
+	static constexpr uint64_t DEFAULT_PROBE_READ_SIZE = 0;
+	static constexpr uint64_t DEFAULT_MAX_RANGES_PER_REQUEST = 32;
+	static constexpr uint64_t DEFAULT_READ_RANGES_CONCURRENCY = 8;
+	static constexpr uint64_t DEFAULT_READ_COALESCE_GAP = 64 * 1024;
+	static constexpr double DEFAULT_HEDGE_PERCENTILE = 0;
+	static constexpr bool DEFAULT_ADAPTIVE_CONCURRENCY = false;
+	static constexpr uint64_t DEFAULT_MAX_CONCURRENT_REQUESTS = 64;
+	static constexpr bool DEFAULT_CONCURRENCY_PER_PREFIX = false;
+	static constexpr uint64_t DEFAULT_IO_THREADS = 64;
+	static constexpr const char *DEFAULT_WRITE_METHOD = "PUT";
+	static constexpr uint64_t DEFAULT_WRITE_BUFFER_SIZE = 8 * 1024 * 1024;
+	static constexpr bool DEFAULT_COMPRESSED_DOWNLOADS = false;
 
 	bool force_download = DEFAULT_FORCE_DOWNLOAD;
 	bool enable_server_cert_verification = DEFAULT_ENABLE_SERVER_CERT_VERIFICATION;
 	idx_t hf_max_per_page = DEFAULT_HF_MAX_PER_PAGE;
+	//! Number of directories listed concurrently while expanding a HuggingFace glob
+	idx_t hf_max_concurrent_listings = DEFAULT_HF_MAX_CONCURRENT_LISTINGS;
+	//! Send range reads of HuggingFace files straight to the (cached) target of the hub's redirect
+	bool hf_cache_redirects = DEFAULT_HF_CACHE_REDIRECTS;
+	//! Url of the HuggingFace hub that hf:// urls are resolved against
+	string hf_endpoint = DEFAULT_HF_ENDPOINT;
+	//! Maximum number of idle connections kept per host for reuse across file handles (0 disables pooling)
+	idx_t connection_pool_size = DEFAULT_CONNECTION_POOL_SIZE;
+	//! Number of connections to open up-front when a glob resolves to many files on the same host
+	idx_t prewarm_connections = DEFAULT_PREWARM_CONNECTIONS;
+	//! Bytes at the end of Parquet files that are fetched in one request by the first read of them (0 disables)
+	idx_t tail_prefetch_size = DEFAULT_TAIL_PREFETCH_SIZE;
+	//! Open files with a range GET of this many bytes instead of a HEAD request (0 uses HEAD)
+	idx_t probe_read_size = DEFAULT_PROBE_READ_SIZE;
+	//! Maximum number of ranges requested together in a multipart/byteranges request (0 or 1 disables them)
+	idx_t max_ranges_per_request = DEFAULT_MAX_RANGES_PER_REQUEST;
+	//! Number of concurrent single range requests when reading multiple ranges
+	idx_t read_ranges_concurrency = DEFAULT_READ_RANGES_CONCURRENCY;
+	//! Ranges of a vectored read that are at most this many bytes apart are fetched as a single range
+	idx_t read_coalesce_gap = DEFAULT_READ_COALESCE_GAP;
+	//! Hedge range requests whose first byte takes longer than this percentile of the host's latency (0 disables)
+	double hedge_percentile = DEFAULT_HEDGE_PERCENTILE;
+	//! Limit the requests in flight per endpoint, backing off when the server responds with 503 or 429
+	bool adaptive_concurrency = DEFAULT_ADAPTIVE_CONCURRENCY;
+	//! Upper bound of the adaptive per-endpoint limit
+	idx_t max_concurrent_requests = DEFAULT_MAX_CONCURRENT_REQUESTS;
+	//! Track the limit per first path segment (e.g. bucket or top-level prefix) instead of per host
+	bool concurrency_per_prefix = DEFAULT_CONCURRENCY_PER_PREFIX;
+	//! Maximum number of threads of the database that run concurrent requests (see HTTPIOExecutor)
+	idx_t io_threads = DEFAULT_IO_THREADS;
+	//! Runs the concurrent requests of multi-range reads, pre-warming and hedging (nullptr starts threads per call)
+	optional_ptr<HTTPIOExecutor> io_executor;
+	//! Method of the request that uploads a file written over plain HTTP(S), PUT or POST
+	string write_method = DEFAULT_WRITE_METHOD;
+	//! Maximum number of bytes of a file being written that are buffered before they are sent
+	idx_t write_buffer_size = DEFAULT_WRITE_BUFFER_SIZE;
+	//! Ask for a compressed (gzip or zstd) response when downloading a whole file, decoding it while it is received
+	bool compressed_downloads = DEFAULT_COMPRESSED_DOWNLOADS;
 	string ca_cert_file;
 	string bearer_token;
 	shared_ptr<HTTPState> state;
 };
 
+//! Content handler for range requests that copies the response body straight into the destination buffer.
+//! HTTPFSClient recognizes it and writes from its socket reader into the buffer directly, without going through the
+//! std::function indirection; other HTTPClient implementations simply call it like any other content handler.
+struct HTTPFSRangeWriter {
+	HTTPFSRangeWriter(data_ptr_t buffer_out, idx_t buffer_out_len, idx_t &out_offset)
+	    : buffer_out(buffer_out), buffer_out_len(buffer_out_len), out_offset(&out_offset) {
+	}
+
+	//! Destination buffer, may be nullptr if the body is to be discarded
+	data_ptr_t buffer_out;
+	idx_t buffer_out_len;
+	//! Shared with the response handler of the request, which resets it when a redirect is followed
+	idx_t *out_offset;
+
+	bool operator()(const_data_ptr_t data, idx_t data_length) {
+		return Write(data, data_length);
+	}
+	bool Write(const_data_ptr_t data, idx_t data_length);
+};
+
+//! Produces the body of a streamed request one chunk at a time: sets `chunk` to the next (non-empty) chunk and returns
+//! true, or returns false once the body is complete. Throwing aborts the request.
+typedef std::function<bool(string &chunk)> HTTPBodySource;
+
 class HTTPFSUtil : public HTTPUtil {
 public:
 	unique_ptr<HTTPParams> InitializeParameters(optional_ptr<FileOpener> opener,
@@ -32,8 +120,35 @@ public:
 
 	static unordered_map<string, string> ParseGetParameters(const string &text);
 	static shared_ptr<HTTPUtil> GetHTTPUtil(optional_ptr<FileOpener> opener);
+	//! Open up to `count` connections to the host of `url` in parallel (by sending a HEAD request over each), leaving
+	//! them in the connection pool for the file handles that are about to be opened. This is best-effort.
+	static void PrewarmConnections(HTTPFSParams &http_params, const string &url, const HTTPHeaders &headers,
+	                               idx_t count);
+
+	//! Send a PUT or POST request to `url` with a body of unknown length, which is sent with chunked transfer encoding
+	//! as `body_source` produces it. The request is not retried, as the body cannot be produced a second time, and for
+	//! the same reason it is sent over a new connection rather than one from the connection pool.
+	unique_ptr<HTTPResponse> SendStreamingRequest(HTTPFSParams &params, const string &method, const string &url,
+	                                              const HTTPHeaders &headers, const HTTPBodySource &body_source);
 
 	string GetName() const override;
+
+	//! Get (or lazily create) the cumulative request statistics of this database
+	shared_ptr<HTTPGlobalStats> GetGlobalStats();
+	//! Get (or lazily create) the threads that run concurrent requests of this database, with at most `max_threads`
+	HTTPIOExecutor &GetIOExecutor(idx_t max_threads);
+
+protected:
+	//! Get (or lazily create) the connection pool shared by all clients of this database
+	shared_ptr<HTTPFSConnectionPool> GetConnectionPool();
+	//! Get (or lazily create) the per-endpoint concurrency limiter shared by all clients of this database
+	shared_ptr<HTTPFSConcurrencyLimiter> GetConcurrencyLimiter();
+
+	mutex connection_pool_lock;
+	shared_ptr<HTTPFSConnectionPool> connection_pool;
+	shared_ptr<HTTPFSConcurrencyLimiter> concurrency_limiter;
+	shared_ptr<HTTPGlobalStats> global_stats;
+	shared_ptr<HTTPIOExecutor> io_executor;
 };
 
 } // namespace duckdb
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+struct HTTPFSInternalFunctions {
+public:
+	//! Register the internal table functions that exercise the read and write paths of HTTPFileSystem. They exist for
+	//! the tests and benchmarks of the extension only: their names start with __internal_ and they are not part of its
+	//! interface.
+	static void Register(DatabaseInstance &instance);
+};
+
+} // namespace duckdb
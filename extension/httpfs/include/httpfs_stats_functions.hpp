@@ -0,0 +1,13 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+struct HTTPFSStatsFunctions {
+public:
+	//! Register the table functions that expose HTTP request statistics
+	static void Register(DatabaseInstance &instance);
+};
+
+} // namespace duckdb
@@ -10,6 +10,7 @@
 #include "duckdb/main/secret/secret_manager.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/common/case_insensitive_map.hpp"
+#include "duckdb/common/unordered_set.hpp"
 #include "httpfs.hpp"
 
 #include <condition_variable>
@@ -32,8 +33,22 @@ struct S3AuthParams {
 	bool s3_url_compatibility_mode = false;
     bool requester_pays = false;
 	string oauth2_bearer_token;  // OAuth2 bearer token for GCS
+	//! Unix time (in seconds) at which the credentials expire, 0 if they do not expire
+	int64_t expiration = 0;
+	//! Credentials are renewed this many seconds before they expire (see `s3_credential_refresh_margin`)
+	int64_t refresh_margin = DEFAULT_REFRESH_MARGIN;
 
+	static constexpr int64_t DEFAULT_REFRESH_MARGIN = 300;
+
+	//! Whether the credentials expire within the refresh margin
+	bool NeedsRefresh() const;
+
+	//! Resolves the parameters for a file from secrets and settings, memoized for the duration of the current query
 	static S3AuthParams ReadFrom(optional_ptr<FileOpener> opener, FileOpenerInfo &info);
+	//! Drops the parameters memoized for the current query, e.g. after a secret was refreshed
+	static void InvalidateCache(optional_ptr<FileOpener> opener);
+
+	static constexpr const char *AUTH_PARAMS_CACHE_NAME = "s3_auth_params_cache";
 };
 
 struct AWSEnvironmentCredentialsProvider {
@@ -70,6 +85,45 @@ struct ParsedS3Url {
 	string GetHTTPUrl(S3AuthParams &auth_params, const string &http_query_string = "");
 };
 
+//! Additional checksum that is sent with uploaded parts and verified for downloaded objects
+enum class S3ChecksumAlgorithm : uint8_t { NONE, CRC32C, CRC64NVME };
+
+//! Helpers for S3 additional checksums: CRCs that are sent base64 encoded, in big-endian byte order
+struct S3Checksum {
+	static uint64_t Compute(S3ChecksumAlgorithm algorithm, const char *data, idx_t length);
+	//! Checksum of `checksum`'s block followed by `data`
+	static uint64_t Update(S3ChecksumAlgorithm algorithm, uint64_t checksum, const char *data, idx_t length);
+	//! Checksum of the concatenation of two blocks, given their checksums and the length of the second block
+	static uint64_t Combine(S3ChecksumAlgorithm algorithm, uint64_t checksum1, uint64_t checksum2, idx_t length2);
+	static string Encode(S3ChecksumAlgorithm algorithm, uint64_t checksum);
+	//! Name as used by S3, e.g. CRC32C
+	static string Name(S3ChecksumAlgorithm algorithm);
+	//! Header that carries the checksum, e.g. x-amz-checksum-crc32c
+	static string HeaderName(S3ChecksumAlgorithm algorithm);
+	static S3ChecksumAlgorithm FromString(const string &name);
+};
+
+//! Checksum of a downloaded object over its body as it was received. S3 checksums an object as it is stored, so for an
+//! object that is stored with a Content-Encoding this is the checksum of the encoded body, not of the decoded file.
+class S3DownloadChecksum : public HTTPRawBodyObserver {
+public:
+	explicit S3DownloadChecksum(S3ChecksumAlgorithm algorithm) : algorithm(algorithm) {
+	}
+
+	void Start(bool decoded_p) override {
+		checksum = 0;
+		decoded = decoded_p;
+	}
+	void Write(const_data_ptr_t data, idx_t length) override {
+		checksum = S3Checksum::Update(algorithm, checksum, const_char_ptr_cast(data), length);
+	}
+
+	S3ChecksumAlgorithm algorithm;
+	uint64_t checksum = 0;
+	//! Whether the body was decoded before it was stored in the file handle
+	bool decoded = false;
+};
+
 struct S3ConfigParams {
 	static constexpr uint64_t DEFAULT_MAX_FILESIZE = 800000000000; // 800GB
 	static constexpr uint64_t DEFAULT_MAX_PARTS_PER_FILE = 10000;  // AWS DEFAULT
@@ -78,6 +132,7 @@ struct S3ConfigParams {
 	uint64_t max_file_size;
 	uint64_t max_parts_per_file;
 	uint64_t max_upload_threads;
+	S3ChecksumAlgorithm checksum_algorithm;
 
 	static S3ConfigParams ReadFrom(optional_ptr<FileOpener> opener);
 };
@@ -88,7 +143,7 @@ class S3FileSystem;
 class S3WriteBuffer {
 public:
 	explicit S3WriteBuffer(idx_t buffer_start, size_t buffer_size, BufferHandle buffer_p)
-	    : idx(0), buffer_start(buffer_start), buffer(std::move(buffer_p)) {
+	    : idx(0), bytes_written(0), buffer_start(buffer_start), buffer(std::move(buffer_p)) {
 		buffer_end = buffer_start + buffer_size;
 		part_no = buffer_start / buffer_size;
 		uploading = false;
@@ -101,7 +156,11 @@ public:
 	// The S3 multipart part number. Note that internally we start at 0 but AWS S3 starts at 1
 	idx_t part_no;
 
-	idx_t idx;
+	//! End of the furthest write into the part, relative to `buffer_start`: the size of the part when it is uploaded
+	atomic<idx_t> idx;
+	//! Total number of bytes written into the part. Writes may arrive in any order but must not overlap, so the part
+	//! is complete once this reaches the part size.
+	atomic<idx_t> bytes_written;
 	idx_t buffer_start;
 	idx_t buffer_end;
 	BufferHandle buffer;
@@ -132,15 +191,33 @@ public:
 	void Close() override;
 	void Initialize(optional_ptr<FileOpener> opener) override;
 
+	//! Returns the credentials to sign a request with, renewing them first if they are about to expire
+	S3AuthParams GetAuthParams();
+	//! Resolves the credentials of the handle again, after refreshing the secrets they come from (if possible).
+	//! Unless `force` is set this only happens if the credentials are about to expire. Returns true if the
+	//! credentials changed.
+	bool RefreshAuthParams(bool force);
+
 	shared_ptr<S3WriteBuffer> GetBuffer(uint16_t write_buffer_idx);
 
 protected:
 	string multipart_upload_id;
 	size_t part_size;
 
+	//! Guards `auth_params` once the handle is in use
+	mutex auth_params_lock;
+	//! The client that opened the file, used to renew the credentials of long-running reads and writes
+	weak_ptr<ClientContext> client_context;
+	//! Unix time of the last attempt to renew the credentials
+	int64_t last_refresh_attempt = 0;
+	//! Minimum number of seconds between attempts to renew the credentials of a handle
+	static constexpr int64_t MIN_REFRESH_INTERVAL = 30;
+
 	//! Write buffers for this file
 	mutex write_buffers_lock;
 	unordered_map<uint16_t, shared_ptr<S3WriteBuffer>> write_buffers;
+	//! Parts whose buffer has been handed off for upload, they can no longer be written to
+	unordered_set<uint16_t> flushed_parts;
 
 	//! Synchronization for upload threads
 	mutex uploads_in_progress_lock;
@@ -151,6 +228,8 @@ protected:
 	//! Etags are stored for each part
 	mutex part_etags_lock;
 	unordered_map<uint16_t, string> part_etags;
+	//! Checksum and size of each part, if additional checksums are enabled (guarded by `part_etags_lock`)
+	unordered_map<uint16_t, pair<uint64_t, idx_t>> part_checksums;
 
 	//! Info for upload
 	atomic<uint16_t> parts_uploaded;
@@ -184,6 +263,10 @@ public:
 	duckdb::unique_ptr<HTTPResponse> GetRangeRequest(FileHandle &handle, string s3_url, HTTPHeaders header_map,
 	                                                 idx_t file_offset, char *buffer_out,
 	                                                 idx_t buffer_out_len) override;
+	//! S3 does not support requests for multiple ranges
+	bool SupportsMultiRangeRequests(FileHandle &handle) override {
+		return false;
+	}
 	duckdb::unique_ptr<HTTPResponse> PostRequest(FileHandle &handle, string s3_url, HTTPHeaders header_map,
 	                                             string &buffer_out, char *buffer_in, idx_t buffer_in_len,
 	                                             string http_params = "") override;
@@ -239,6 +322,9 @@ protected:
 
 	void FlushBuffer(S3FileHandle &handle, shared_ptr<S3WriteBuffer> write_buffer);
 	string GetPayloadHash(char *buffer, idx_t buffer_len);
+	//! Verify a downloaded object against the full-object checksum S3 returned with it, if any
+	static void VerifyDownloadChecksum(S3FileHandle &handle, const HTTPResponse &response,
+	                                   const S3DownloadChecksum &received_checksum);
 
 	HTTPException GetHTTPError(FileHandle &, const HTTPResponse &response, const string &url) override;
 };
@@ -1,6 +1,7 @@
 #include "s3fs.hpp"
 
 #include "crypto.hpp"
+#include "hash_functions.hpp"
 #include "duckdb.hpp"
 #ifndef DUCKDB_AMALGAMATION
 #include "duckdb/common/exception/http_exception.hpp"
@@ -8,29 +9,43 @@
 #include "duckdb/logging/file_system_logger.hpp"
 #include "duckdb/common/helper.hpp"
 #include "duckdb/common/thread.hpp"
+#include "duckdb/common/types/blob.hpp"
 #include "duckdb/common/types/timestamp.hpp"
 #include "duckdb/function/scalar/strftime_format.hpp"
+#include "http_params_cache.hpp"
 #include "http_state.hpp"
 #endif
 
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/function/scalar/string_common.hpp"
+#include "duckdb/main/client_context_file_opener.hpp"
 #include "duckdb/main/secret/secret_manager.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 
 #include "create_secret_functions.hpp"
 
 #include <iostream>
+#include <map>
 #include <thread>
 
 namespace duckdb {
 
 static HTTPHeaders create_s3_header(string url, string query, string host, string service, string method,
                                     const S3AuthParams &auth_params, string date_now = "", string datetime_now = "",
-                                    string payload_hash = "", string content_type = "") {
+                                    string payload_hash = "", string content_type = "",
+                                    const HTTPHeaders &checksum_headers = HTTPHeaders()) {
 
 	HTTPHeaders res;
 	res["Host"] = host;
+	// x-amz-checksum-* headers of additional checksums, which are signed like all x-amz-* headers (in sorted order)
+	std::map<string, string> signed_checksum_headers;
+	for (auto &entry : checksum_headers) {
+		auto name = StringUtil::Lower(entry.first);
+		if (StringUtil::StartsWith(name, "x-amz-checksum-")) {
+			signed_checksum_headers[name] = entry.second;
+			res[name] = entry.second;
+		}
+	}
 	// If access key is not set, we don't set the headers at all to allow accessing public files through s3 urls
 	if (auth_params.secret_access_key.empty() && auth_params.access_key_id.empty()) {
 		return res;
@@ -73,7 +88,11 @@ static HTTPHeaders create_s3_header(string url, string query, string host, strin
 	if (content_type.length() > 0) {
 		signed_headers += "content-type;";
 	}
-	signed_headers += "host;x-amz-content-sha256;x-amz-date";
+	signed_headers += "host;";
+	for (auto &entry : signed_checksum_headers) {
+		signed_headers += entry.first + ";";
+	}
+	signed_headers += "x-amz-content-sha256;x-amz-date";
 	if (use_requester_pays) {
 		signed_headers += ";x-amz-request-payer";
 	}
@@ -87,7 +106,11 @@ static HTTPHeaders create_s3_header(string url, string query, string host, strin
 	if (content_type.length() > 0) {
 		canonical_request += "\ncontent-type:" + content_type;
 	}
-	canonical_request += "\nhost:" + host + "\nx-amz-content-sha256:" + payload_hash + "\nx-amz-date:" + datetime_now;
+	canonical_request += "\nhost:" + host;
+	for (auto &entry : signed_checksum_headers) {
+		canonical_request += "\n" + entry.first + ":" + entry.second;
+	}
+	canonical_request += "\nx-amz-content-sha256:" + payload_hash + "\nx-amz-date:" + datetime_now;
 	if (use_requester_pays) {
 		canonical_request += "\nx-amz-request-payer:requester";
 	}
@@ -178,16 +201,32 @@ S3AuthParams AWSEnvironmentCredentialsProvider::CreateParams() {
 	return params;
 }
 
-S3AuthParams S3AuthParams::ReadFrom(optional_ptr<FileOpener> opener, FileOpenerInfo &info) {
-	auto result = S3AuthParams();
+static const char *S3_SECRET_TYPES[] = {"s3", "r2", "gcs", "aws"};
 
-	// Without a FileOpener we can not access settings nor secrets: return empty auth params
-	if (!opener) {
-		return result;
+//! Refreshes the secrets matching `path` that know how to refresh themselves. Returns true if any was refreshed.
+static bool TryRefreshS3Secrets(ClientContext &context, const string &path) {
+	bool refreshed_secret = false;
+	auto transaction = CatalogTransaction::GetSystemCatalogTransaction(context);
+	for (const string type : S3_SECRET_TYPES) {
+		auto res = context.db->GetSecretManager().LookupSecret(transaction, path, type);
+		if (res.HasMatch()) {
+			refreshed_secret |= CreateS3SecretFunctions::TryRefreshS3Secret(context, *res.secret_entry);
+		}
 	}
+	return refreshed_secret;
+}
 
-	const char *secret_types[] = {"s3", "r2", "gcs", "aws"};
-	KeyValueSecretReader secret_reader(*opener, info, secret_types, 3);
+static int64_t GetCurrentEpochSeconds() {
+	return Timestamp::GetEpochSeconds(Timestamp::GetCurrentTimestamp());
+}
+
+bool S3AuthParams::NeedsRefresh() const {
+	return expiration != 0 && GetCurrentEpochSeconds() + refresh_margin >= expiration;
+}
+
+static S3AuthParams ReadAuthParams(FileOpener &opener, FileOpenerInfo &info) {
+	auto result = S3AuthParams();
+	KeyValueSecretReader secret_reader(opener, info, S3_SECRET_TYPES, 3);
 
 	// These settings we just set or leave to their S3AuthParams default value
 	secret_reader.TryGetSecretKeyOrSetting("region", "s3_region", result.region);
@@ -224,9 +263,66 @@ S3AuthParams S3AuthParams::ReadFrom(optional_ptr<FileOpener> opener, FileOpenerI
 	    result.endpoint = "s3.amazonaws.com";
 	}
 
+	Value expiration;
+	if (secret_reader.TryGetSecretKey("expiration", expiration) && !expiration.IsNull()) {
+		auto expiration_str = expiration.ToString();
+		timestamp_t expiration_ts;
+		if (Timestamp::TryConvertTimestamp(expiration_str.c_str(), expiration_str.size(), expiration_ts) ==
+		    TimestampCastResult::SUCCESS) {
+			result.expiration = Timestamp::GetEpochSeconds(expiration_ts);
+		} else {
+			// The credentials are still usable, they are just not refreshed ahead of their expiration
+			DUCKDB_LOG_WARN(opener, "Ignoring the malformed expiration '%s' of the S3 secret for '%s'", expiration_str,
+			                info.file_path);
+		}
+	}
+	FileOpener::TryGetCurrentSetting(&opener, "s3_credential_refresh_margin", result.refresh_margin, &info);
+
 	return result;
 }
 
+S3AuthParams S3AuthParams::ReadFrom(optional_ptr<FileOpener> opener, FileOpenerInfo &info) {
+	// Without a FileOpener we can not access settings nor secrets: return empty auth params
+	if (!opener) {
+		return S3AuthParams();
+	}
+
+	// The resolved parameters are reused within a query for all files that match the same secrets and use the same
+	// scheme (gcs urls are treated differently)
+	auto cache = HTTPParamsCache<S3AuthParams>::TryGetCache(opener, AUTH_PARAMS_CACHE_NAME);
+	string cache_key;
+	if (cache && cache->TryGetSecretMatchKey(opener, info.file_path, S3_SECRET_TYPES, 3, cache_key)) {
+		cache_key += info.file_path.substr(0, info.file_path.find("://"));
+		auto cached = cache->TryGet(cache_key);
+		if (cached && !cached->NeedsRefresh()) {
+			return *cached;
+		}
+	} else {
+		cache = nullptr;
+	}
+
+	auto result = ReadAuthParams(*opener, info);
+	if (result.NeedsRefresh()) {
+		// Renew credentials that are about to expire before they are used, rather than after a request failed
+		auto context = FileOpener::TryGetClientContext(opener);
+		if (context && TryRefreshS3Secrets(*context, info.file_path)) {
+			result = ReadAuthParams(*opener, info);
+		}
+	}
+
+	if (cache) {
+		cache->Insert(cache_key, result);
+	}
+	return result;
+}
+
+void S3AuthParams::InvalidateCache(optional_ptr<FileOpener> opener) {
+	auto cache = HTTPParamsCache<S3AuthParams>::TryGetCache(opener, AUTH_PARAMS_CACHE_NAME);
+	if (cache) {
+		cache->Clear();
+	}
+}
+
 unique_ptr<KeyValueSecret> CreateSecret(vector<string> &prefix_paths_p, string &type, string &provider, string &name,
                                         S3AuthParams &params) {
 	auto return_value = make_uniq<KeyValueSecret>(prefix_paths_p, type, provider, name);
@@ -254,15 +350,16 @@ unique_ptr<KeyValueSecret> CreateSecret(vector<string> &prefix_paths_p, string &
 }
 
 S3FileHandle::~S3FileHandle() {
-	if (Exception::UncaughtException()) {
-		// We are in an exception, don't do anything
-		return;
-	}
-
-	try {
-		Close();
-	} catch (...) { // NOLINT
+	// If we are in an exception, don't finish the upload
+	if (!Exception::UncaughtException()) {
+		try {
+			Close();
+		} catch (...) { // NOLINT
+		}
 	}
+	// Parts that are still being uploaded (e.g. when a write failed, or a gap was found on closing) use the handle
+	unique_lock<mutex> lck(uploads_in_progress_lock);
+	final_flush_cv.wait(lck, [this] { return uploads_in_progress == 0; });
 }
 
 S3ConfigParams S3ConfigParams::ReadFrom(optional_ptr<FileOpener> opener) {
@@ -289,7 +386,12 @@ S3ConfigParams S3ConfigParams::ReadFrom(optional_ptr<FileOpener> opener) {
 		max_upload_threads = S3ConfigParams::DEFAULT_MAX_UPLOAD_THREADS;
 	}
 
-	return {uploader_max_filesize, max_parts_per_file, max_upload_threads};
+	auto checksum_algorithm = S3ChecksumAlgorithm::NONE;
+	if (FileOpener::TryGetCurrentSetting(opener, "s3_checksum_algorithm", value)) {
+		checksum_algorithm = S3Checksum::FromString(value.ToString());
+	}
+
+	return {uploader_max_filesize, max_parts_per_file, max_upload_threads, checksum_algorithm};
 }
 
 void S3FileHandle::Close() {
@@ -303,7 +405,8 @@ void S3FileHandle::Close() {
 }
 
 unique_ptr<HTTPClient> S3FileHandle::CreateClient() {
-	auto parsed_url = S3FileSystem::S3UrlParse(path, this->auth_params);
+	auto auth_params = GetAuthParams();
+	auto parsed_url = S3FileSystem::S3UrlParse(path, auth_params);
 
 	string proto_host_port = parsed_url.http_proto + parsed_url.host;
 	return http_params.http_util.InitializeClient(http_params, proto_host_port);
@@ -316,7 +419,15 @@ string S3FileSystem::InitializeMultipartUpload(S3FileHandle &file_handle) {
 	// AWS response is around 300~ chars in docs so this should be enough to not need a resize
 	string result;
 	string query_param = "uploads=";
-	auto res = s3fs.PostRequest(file_handle, file_handle.path, {}, result, nullptr, 0, query_param);
+	HTTPHeaders headers;
+	auto checksum_algorithm = file_handle.config_params.checksum_algorithm;
+	if (checksum_algorithm != S3ChecksumAlgorithm::NONE) {
+		// The parts carry CRCs that are combined into a checksum of the whole object when the upload completes, which
+		// (unlike a composite checksum of the parts) can be verified when the object is downloaded
+		headers["x-amz-checksum-algorithm"] = S3Checksum::Name(checksum_algorithm);
+		headers["x-amz-checksum-type"] = "FULL_OBJECT";
+	}
+	auto res = s3fs.PostRequest(file_handle, file_handle.path, headers, result, nullptr, 0, query_param);
 
 	if (res->status != HTTPStatusCode::OK_200) {
 		throw HTTPException(*res, "Unable to connect to URL %s: %s (HTTP code %d)", res->url, res->GetError(),
@@ -353,9 +464,17 @@ void S3FileSystem::UploadBuffer(S3FileHandle &file_handle, shared_ptr<S3WriteBuf
 	                     "uploadId=" + S3FileSystem::UrlEncode(file_handle.multipart_upload_id, true);
 	unique_ptr<HTTPResponse> res;
 	string etag;
+	HTTPHeaders headers;
+	uint64_t checksum = 0;
+	idx_t part_length = write_buffer->idx;
+	auto checksum_algorithm = file_handle.config_params.checksum_algorithm;
 
 	try {
-		res = s3fs.PutRequest(file_handle, file_handle.path, {}, (char *)write_buffer->Ptr(), write_buffer->idx,
+		if (checksum_algorithm != S3ChecksumAlgorithm::NONE) {
+			checksum = S3Checksum::Compute(checksum_algorithm, (char *)write_buffer->Ptr(), part_length);
+			headers[S3Checksum::HeaderName(checksum_algorithm)] = S3Checksum::Encode(checksum_algorithm, checksum);
+		}
+		res = s3fs.PutRequest(file_handle, file_handle.path, headers, (char *)write_buffer->Ptr(), part_length,
 		                      query_param);
 
 		if (res->status != HTTPStatusCode::OK_200) {
@@ -387,6 +506,9 @@ void S3FileSystem::UploadBuffer(S3FileHandle &file_handle, shared_ptr<S3WriteBuf
 	{
 		unique_lock<mutex> lck(file_handle.part_etags_lock);
 		file_handle.part_etags.insert(std::pair<uint16_t, string>(write_buffer->part_no, etag));
+		if (checksum_algorithm != S3ChecksumAlgorithm::NONE) {
+			file_handle.part_checksums[write_buffer->part_no] = make_pair(checksum, part_length);
+		}
 	}
 
 	file_handle.parts_uploaded++;
@@ -416,6 +538,7 @@ void S3FileSystem::FlushBuffer(S3FileHandle &file_handle, shared_ptr<S3WriteBuff
 	{
 		unique_lock<mutex> lck(file_handle.write_buffers_lock);
 		file_handle.write_buffers.erase(write_buffer->part_no);
+		file_handle.flushed_parts.insert(write_buffer->part_no);
 	}
 
 	{
@@ -440,12 +563,29 @@ void S3FileSystem::FlushBuffer(S3FileHandle &file_handle, shared_ptr<S3WriteBuff
 void S3FileSystem::FlushAllBuffers(S3FileHandle &file_handle) {
 	//  Collect references to all buffers to check
 	vector<shared_ptr<S3WriteBuffer>> to_flush;
+	idx_t last_part = 0;
 	file_handle.write_buffers_lock.lock();
 	for (auto &item : file_handle.write_buffers) {
 		to_flush.push_back(item.second);
+		last_part = MaxValue<idx_t>(last_part, item.first);
+	}
+	for (auto &part_no : file_handle.flushed_parts) {
+		last_part = MaxValue<idx_t>(last_part, part_no);
 	}
 	file_handle.write_buffers_lock.unlock();
 
+	// Parts can be written out of order: before uploading the remaining ones, check that they leave no holes. All parts
+	// but the last must be full, the last one must be filled up to the furthest write.
+	for (auto &write_buffer : to_flush) {
+		auto expected_size = write_buffer->part_no == last_part ? write_buffer->idx.load() : file_handle.part_size;
+		if (write_buffer->bytes_written != expected_size) {
+			throw IOException("Unable to finish writing S3 file '%s': part %d was not written entirely (%d of %d "
+			                  "bytes), which would leave a gap in the file",
+			                  file_handle.path, write_buffer->part_no + 1, write_buffer->bytes_written.load(),
+			                  expected_size);
+		}
+	}
+
 	// Flush all buffers that aren't already uploading
 	for (auto &write_buffer : to_flush) {
 		if (!write_buffer->uploading) {
@@ -465,28 +605,65 @@ void S3FileSystem::FinalizeMultipartUpload(S3FileHandle &file_handle) {
 	std::stringstream ss;
 	ss << "<CompleteMultipartUpload xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">";
 
+	auto checksum_algorithm = file_handle.config_params.checksum_algorithm;
+	auto checksum_tag = "Checksum" + S3Checksum::Name(checksum_algorithm);
+	uint64_t object_checksum = 0;
 	auto parts = file_handle.parts_uploaded.load();
 	for (auto i = 0; i < parts; i++) {
 		auto etag_lookup = file_handle.part_etags.find(i);
 		if (etag_lookup == file_handle.part_etags.end()) {
-			throw IOException("Unknown part number");
+			throw IOException("Unable to finish writing S3 file '%s': part %d is missing, the file was not written "
+			                  "contiguously",
+			                  file_handle.path, i + 1);
+		}
+		ss << "<Part>";
+		if (checksum_algorithm != S3ChecksumAlgorithm::NONE) {
+			auto &part_checksum = file_handle.part_checksums[i];
+			ss << "<" << checksum_tag << ">" << S3Checksum::Encode(checksum_algorithm, part_checksum.first) << "</"
+			   << checksum_tag << ">";
+			object_checksum = i == 0 ? part_checksum.first
+			                         : S3Checksum::Combine(checksum_algorithm, object_checksum, part_checksum.first,
+			                                               part_checksum.second);
 		}
-		ss << "<Part><ETag>" << etag_lookup->second << "</ETag><PartNumber>" << i + 1 << "</PartNumber></Part>";
+		ss << "<ETag>" << etag_lookup->second << "</ETag><PartNumber>" << i + 1 << "</PartNumber></Part>";
 	}
 	ss << "</CompleteMultipartUpload>";
 	string body = ss.str();
 
+	HTTPHeaders headers;
+	string expected_checksum;
+	if (checksum_algorithm != S3ChecksumAlgorithm::NONE) {
+		// S3 rejects the request if the object it assembled does not match the checksum computed from our parts
+		expected_checksum = S3Checksum::Encode(checksum_algorithm, object_checksum);
+		headers[S3Checksum::HeaderName(checksum_algorithm)] = expected_checksum;
+		headers["x-amz-checksum-type"] = "FULL_OBJECT";
+	}
+
 	// Response is around ~400 in AWS docs so this should be enough to not need a resize
 	string result;
 
 	string query_param = "uploadId=" + S3FileSystem::UrlEncode(file_handle.multipart_upload_id, true);
-	auto res =
-	    s3fs.PostRequest(file_handle, file_handle.path, {}, result, (char *)body.c_str(), body.length(), query_param);
+	auto res = s3fs.PostRequest(file_handle, file_handle.path, headers, result, (char *)body.c_str(), body.length(),
+	                            query_param);
 	auto open_tag_pos = result.find("<CompleteMultipartUploadResult", 0);
 	if (open_tag_pos == string::npos) {
 		throw HTTPException(*res, "Unexpected response during S3 multipart upload finalization: %d\n\n%s",
 		                    static_cast<int>(res->status), result);
 	}
+	if (checksum_algorithm != S3ChecksumAlgorithm::NONE) {
+		// Not all S3-compatible stores check the header: compare with the checksum they report, if any
+		auto checksum_pos = result.find("<" + checksum_tag + ">", open_tag_pos);
+		if (checksum_pos != string::npos) {
+			checksum_pos += checksum_tag.size() + 2;
+			auto reported_checksum = result.substr(checksum_pos, result.find('<', checksum_pos) - checksum_pos);
+			if (reported_checksum != expected_checksum) {
+				throw IOException("Checksum mismatch after uploading S3 file '%s': expected %s %s, the server "
+				                  "reported %s",
+				                  file_handle.path, S3Checksum::Name(checksum_algorithm), expected_checksum,
+				                  reported_checksum);
+			}
+		}
+	}
 }
 
 // Wrapper around the BufferManager::Allocate to that allows limiting the number of buffers that will be handed out
@@ -505,6 +682,11 @@ shared_ptr<S3WriteBuffer> S3FileHandle::GetBuffer(uint16_t write_buffer_idx) {
 			shared_ptr<S3WriteBuffer> buffer = lookup_result->second;
 			return buffer;
 		}
+		if (flushed_parts.find(write_buffer_idx) != flushed_parts.end()) {
+			throw IOException("Unable to write to S3 file '%s': part %d was already uploaded, parts of S3 files can "
+			                  "only be written once",
+			                  path, write_buffer_idx + 1);
+		}
 	}
 
 	auto buffer_handle = s3fs.Allocate(part_size, config_params.max_upload_threads);
@@ -656,6 +838,74 @@ ParsedS3Url S3FileSystem::S3UrlParse(string url, S3AuthParams &params) {
 	return {http_proto, prefix, host, bucket, key, path, query_param, trimmed_s3_url};
 }
 
+uint64_t S3Checksum::Compute(S3ChecksumAlgorithm algorithm, const char *data, idx_t length) {
+	return Update(algorithm, 0, data, length);
+}
+
+uint64_t S3Checksum::Update(S3ChecksumAlgorithm algorithm, uint64_t checksum, const char *data, idx_t length) {
+	switch (algorithm) {
+	case S3ChecksumAlgorithm::CRC32C:
+		return crc32c(UnsafeNumericCast<uint32_t>(checksum), data, length);
+	case S3ChecksumAlgorithm::CRC64NVME:
+		return crc64nvme(checksum, data, length);
+	default:
+		throw InternalException("Unsupported S3 checksum algorithm");
+	}
+}
+
+uint64_t S3Checksum::Combine(S3ChecksumAlgorithm algorithm, uint64_t checksum1, uint64_t checksum2, idx_t length2) {
+	switch (algorithm) {
+	case S3ChecksumAlgorithm::CRC32C:
+		return crc32c_combine(UnsafeNumericCast<uint32_t>(checksum1), UnsafeNumericCast<uint32_t>(checksum2),
+		                      length2);
+	case S3ChecksumAlgorithm::CRC64NVME:
+		return crc64nvme_combine(checksum1, checksum2, length2);
+	default:
+		throw InternalException("Unsupported S3 checksum algorithm");
+	}
+}
+
+string S3Checksum::Encode(S3ChecksumAlgorithm algorithm, uint64_t checksum) {
+	idx_t width = algorithm == S3ChecksumAlgorithm::CRC32C ? sizeof(uint32_t) : sizeof(uint64_t);
+	char bytes[sizeof(uint64_t)];
+	for (idx_t i = 0; i < width; i++) {
+		bytes[i] = static_cast<char>(checksum >> (8 * (width - 1 - i)));
+	}
+	string_t blob(bytes, UnsafeNumericCast<uint32_t>(width));
+	string result(Blob::ToBase64Size(blob), '\0');
+	Blob::ToBase64(blob, &result[0]);
+	return result;
+}
+
+string S3Checksum::Name(S3ChecksumAlgorithm algorithm) {
+	switch (algorithm) {
+	case S3ChecksumAlgorithm::CRC32C:
+		return "CRC32C";
+	case S3ChecksumAlgorithm::CRC64NVME:
+		return "CRC64NVME";
+	default:
+		return "";
+	}
+}
+
+string S3Checksum::HeaderName(S3ChecksumAlgorithm algorithm) {
+	return "x-amz-checksum-" + StringUtil::Lower(Name(algorithm));
+}
+
+S3ChecksumAlgorithm S3Checksum::FromString(const string &name) {
+	auto upper = StringUtil::Upper(name);
+	if (upper.empty() || upper == "NONE") {
+		return S3ChecksumAlgorithm::NONE;
+	}
+	if (upper == "CRC32C") {
+		return S3ChecksumAlgorithm::CRC32C;
+	}
+	if (upper == "CRC64NVME") {
+		return S3ChecksumAlgorithm::CRC64NVME;
+	}
+	throw InvalidInputException("Unsupported s3_checksum_algorithm \"%s\", expected NONE, CRC32C or CRC64NVME", name);
+}
+
 string S3FileSystem::GetPayloadHash(char *buffer, idx_t buffer_len) {
 	if (buffer_len > 0) {
 		hash_bytes payload_hash_bytes;
@@ -680,7 +930,7 @@ string ParsedS3Url::GetHTTPUrl(S3AuthParams &auth_params, const string &http_que
 unique_ptr<HTTPResponse> S3FileSystem::PostRequest(FileHandle &handle, string url, HTTPHeaders header_map,
                                                    string &result, char *buffer_in, idx_t buffer_in_len,
                                                    string http_params) {
-	auto auth_params = handle.Cast<S3FileHandle>().auth_params;
+	auto auth_params = handle.Cast<S3FileHandle>().GetAuthParams();
 	auto parsed_s3_url = S3UrlParse(url, auth_params);
 	string http_url = parsed_s3_url.GetHTTPUrl(auth_params, http_params);
 	
@@ -694,7 +944,7 @@ unique_ptr<HTTPResponse> S3FileSystem::PostRequest(FileHandle &handle, string ur
 		// Use existing S3 authentication
 		auto payload_hash = GetPayloadHash(buffer_in, buffer_in_len);
 		headers = create_s3_header(parsed_s3_url.path, http_params, parsed_s3_url.host, "s3", "POST", auth_params, "",
-		                          "", payload_hash, "application/octet-stream");
+		                          "", payload_hash, "application/octet-stream", header_map);
 	}
 
 	return HTTPFileSystem::PostRequest(handle, http_url, headers, result, buffer_in, buffer_in_len);
@@ -702,7 +952,7 @@ unique_ptr<HTTPResponse> S3FileSystem::PostRequest(FileHandle &handle, string ur
 
 unique_ptr<HTTPResponse> S3FileSystem::PutRequest(FileHandle &handle, string url, HTTPHeaders header_map,
                                                   char *buffer_in, idx_t buffer_in_len, string http_params) {
-	auto auth_params = handle.Cast<S3FileHandle>().auth_params;
+	auto auth_params = handle.Cast<S3FileHandle>().GetAuthParams();
 	auto parsed_s3_url = S3UrlParse(url, auth_params);
 	string http_url = parsed_s3_url.GetHTTPUrl(auth_params, http_params);
 	auto content_type = "application/octet-stream";
@@ -714,17 +964,23 @@ unique_ptr<HTTPResponse> S3FileSystem::PutRequest(FileHandle &handle, string url
 		headers["Host"] = parsed_s3_url.host;
 		headers["Content-Type"] = content_type;
 	} else {
-		// Use existing S3 authentication
-		auto payload_hash = GetPayloadHash(buffer_in, buffer_in_len);
+		// Use existing S3 authentication. If the payload carries an additional checksum, S3 verifies its integrity
+		// already: over TLS, the much more expensive SHA-256 of the payload can be skipped.
+		bool has_checksum = false;
+		for (auto &entry : header_map) {
+			has_checksum = has_checksum || StringUtil::StartsWith(StringUtil::Lower(entry.first), "x-amz-checksum-");
+		}
+		auto payload_hash =
+		    has_checksum && auth_params.use_ssl ? "UNSIGNED-PAYLOAD" : GetPayloadHash(buffer_in, buffer_in_len);
 		headers = create_s3_header(parsed_s3_url.path, http_params, parsed_s3_url.host, "s3", "PUT", auth_params, "",
-		                          "", payload_hash, content_type);
+		                          "", payload_hash, content_type, header_map);
 	}
 	
 	return HTTPFileSystem::PutRequest(handle, http_url, headers, buffer_in, buffer_in_len);
 }
 
 unique_ptr<HTTPResponse> S3FileSystem::HeadRequest(FileHandle &handle, string s3_url, HTTPHeaders header_map) {
-	auto auth_params = handle.Cast<S3FileHandle>().auth_params;
+	auto auth_params = handle.Cast<S3FileHandle>().GetAuthParams();
 	auto parsed_s3_url = S3UrlParse(s3_url, auth_params);
 	string http_url = parsed_s3_url.GetHTTPUrl(auth_params);
 	
@@ -743,7 +999,8 @@ unique_ptr<HTTPResponse> S3FileSystem::HeadRequest(FileHandle &handle, string s3
 }
 
 unique_ptr<HTTPResponse> S3FileSystem::GetRequest(FileHandle &handle, string s3_url, HTTPHeaders header_map) {
-	auto auth_params = handle.Cast<S3FileHandle>().auth_params;
+	auto &s3fh = handle.Cast<S3FileHandle>();
+	auto auth_params = s3fh.GetAuthParams();
 	auto parsed_s3_url = S3UrlParse(s3_url, auth_params);
 	string http_url = parsed_s3_url.GetHTTPUrl(auth_params);
 	
@@ -753,17 +1010,73 @@ unique_ptr<HTTPResponse> S3FileSystem::GetRequest(FileHandle &handle, string s3_
 		headers["Authorization"] = "Bearer " + auth_params.oauth2_bearer_token;
 		headers["Host"] = parsed_s3_url.host;
 	} else {
-		// Use existing S3 authentication
+		// Use existing S3 authentication. The whole object is downloaded: ask for its checksum to verify it.
+		HTTPHeaders checksum_headers;
+		if (s3fh.config_params.checksum_algorithm != S3ChecksumAlgorithm::NONE) {
+			checksum_headers["x-amz-checksum-mode"] = "ENABLED";
+		}
 		headers = create_s3_header(parsed_s3_url.path, "", parsed_s3_url.host, 
-		                          "s3", "GET", auth_params, "", "", "", "");
+		                          "s3", "GET", auth_params, "", "", "", "", checksum_headers);
 	}
 	
-	return HTTPFileSystem::GetRequest(handle, http_url, headers);
+	auto checksum_algorithm = s3fh.config_params.checksum_algorithm;
+	if (checksum_algorithm == S3ChecksumAlgorithm::NONE) {
+		return HTTPFileSystem::GetRequest(handle, http_url, headers);
+	}
+	S3DownloadChecksum received_checksum(checksum_algorithm);
+	auto response = HTTPFileSystem::GetRequest(handle, http_url, headers, &received_checksum);
+	if (response->Success()) {
+		VerifyDownloadChecksum(s3fh, *response, received_checksum);
+	}
+	return response;
+}
+
+void S3FileSystem::VerifyDownloadChecksum(S3FileHandle &handle, const HTTPResponse &response,
+                                          const S3DownloadChecksum &received_checksum) {
+	for (auto algorithm : {S3ChecksumAlgorithm::CRC32C, S3ChecksumAlgorithm::CRC64NVME}) {
+		auto header_name = S3Checksum::HeaderName(algorithm);
+		if (!response.headers.HasHeader(header_name)) {
+			continue;
+		}
+		auto expected_checksum = response.headers.GetHeaderValue(header_name);
+		if (expected_checksum.find('-') != string::npos) {
+			// a composite checksum of the parts ("<checksum>-<parts>"), which cannot be verified without knowing the
+			// part boundaries
+			return;
+		}
+		// S3 checksums the object as it is stored, i.e. the body as it was sent if the object has a Content-Encoding
+		auto computed_while_received = received_checksum.algorithm == algorithm;
+		string actual_checksum;
+		if (computed_while_received) {
+			actual_checksum = S3Checksum::Encode(algorithm, received_checksum.checksum);
+			if (actual_checksum == expected_checksum) {
+				return;
+			}
+		}
+		if (received_checksum.decoded || !computed_while_received) {
+			// the checksum of the body that was stored in the handle, which is what S3 checksummed if the body was not
+			// decoded, or if its Content-Encoding was applied in transit (e.g. by a proxy) rather than stored
+			auto checksum = S3Checksum::Compute(algorithm, handle.cached_file_handle->GetData(), handle.length);
+			auto decoded_checksum = S3Checksum::Encode(algorithm, checksum);
+			if (decoded_checksum == expected_checksum) {
+				return;
+			}
+			if (!computed_while_received) {
+				if (received_checksum.decoded) {
+					// the checksum of the body as it was sent is unknown
+					return;
+				}
+				actual_checksum = decoded_checksum;
+			}
+		}
+		throw IOException("Checksum mismatch when downloading S3 file '%s': expected %s %s, got %s", handle.path,
+		                  S3Checksum::Name(algorithm), expected_checksum, actual_checksum);
+	}
 }
 
 unique_ptr<HTTPResponse> S3FileSystem::GetRangeRequest(FileHandle &handle, string s3_url, HTTPHeaders header_map,
                                                        idx_t file_offset, char *buffer_out, idx_t buffer_out_len) {
-	auto auth_params = handle.Cast<S3FileHandle>().auth_params;
+	auto auth_params = handle.Cast<S3FileHandle>().GetAuthParams();
 	auto parsed_s3_url = S3UrlParse(s3_url, auth_params);
 	string http_url = parsed_s3_url.GetHTTPUrl(auth_params);
 	
@@ -778,11 +1091,23 @@ unique_ptr<HTTPResponse> S3FileSystem::GetRangeRequest(FileHandle &handle, strin
 		                          "s3", "GET", auth_params, "", "", "", "");
 	}
 	
-	return HTTPFileSystem::GetRangeRequest(handle, http_url, headers, file_offset, buffer_out, buffer_out_len);
+	try {
+		return HTTPFileSystem::GetRangeRequest(handle, http_url, headers, file_offset, buffer_out, buffer_out_len);
+	} catch (HTTPException &ex) {
+		// Credentials can expire while a file is being read: retry once with renewed credentials
+		auto status = ex.GetStatusCode();
+		if (status != 400 && status != 403) {
+			throw;
+		}
+		if (!handle.Cast<S3FileHandle>().RefreshAuthParams(true)) {
+			throw;
+		}
+	}
+	return GetRangeRequest(handle, s3_url, std::move(header_map), file_offset, buffer_out, buffer_out_len);
 }
 
 unique_ptr<HTTPResponse> S3FileSystem::DeleteRequest(FileHandle &handle, string s3_url, HTTPHeaders header_map) {
-	auto auth_params = handle.Cast<S3FileHandle>().auth_params;
+	auto auth_params = handle.Cast<S3FileHandle>().GetAuthParams();
 	auto parsed_s3_url = S3UrlParse(s3_url, auth_params);
 	string http_url = parsed_s3_url.GetHTTPUrl(auth_params);
 	
@@ -816,22 +1141,64 @@ unique_ptr<HTTPFileHandle> S3FileSystem::CreateHandle(const OpenFileInfo &file,
 	                                       S3ConfigParams::ReadFrom(opener));
 }
 
+S3AuthParams S3FileHandle::GetAuthParams() {
+	{
+		lock_guard<mutex> guard(auth_params_lock);
+		if (!auth_params.NeedsRefresh()) {
+			return auth_params;
+		}
+	}
+	RefreshAuthParams(false);
+	lock_guard<mutex> guard(auth_params_lock);
+	return auth_params;
+}
+
+bool S3FileHandle::RefreshAuthParams(bool force) {
+	auto context = client_context.lock();
+	if (!context) {
+		return false;
+	}
+	lock_guard<mutex> guard(auth_params_lock);
+	if (!force && !auth_params.NeedsRefresh()) {
+		// renewed by another thread in the meantime
+		return false;
+	}
+	auto now = GetCurrentEpochSeconds();
+	if (now < last_refresh_attempt + MIN_REFRESH_INTERVAL) {
+		return false;
+	}
+	last_refresh_attempt = now;
+
+	TryRefreshS3Secrets(*context, path);
+	ClientContextFileOpener opener(*context);
+	S3AuthParams::InvalidateCache(&opener);
+	FileOpenerInfo info = {path};
+	auto new_params = S3AuthParams::ReadFrom(&opener, info);
+	// Credentials passed in the url take precedence, as when the file was opened
+	auto &s3fs = file_system.Cast<S3FileSystem>();
+	s3fs.ReadQueryParams(S3FileSystem::S3UrlParse(path, new_params).query_param, new_params);
+
+	bool changed = new_params.access_key_id != auth_params.access_key_id ||
+	               new_params.secret_access_key != auth_params.secret_access_key ||
+	               new_params.session_token != auth_params.session_token ||
+	               new_params.oauth2_bearer_token != auth_params.oauth2_bearer_token;
+	auth_params = std::move(new_params);
+	return changed;
+}
+
 void S3FileHandle::Initialize(optional_ptr<FileOpener> opener) {
+	auto context = FileOpener::TryGetClientContext(opener);
+	if (context) {
+		client_context = context->shared_from_this();
+	}
 	try {
 		HTTPFileHandle::Initialize(opener);
 	} catch (std::exception &ex) {
 		ErrorData error(ex);
 		bool refreshed_secret = false;
 		if (error.Type() == ExceptionType::IO || error.Type() == ExceptionType::HTTP) {
-			auto context = opener->TryGetClientContext();
 			if (context) {
-				auto transaction = CatalogTransaction::GetSystemCatalogTransaction(*context);
-				for (const string type : {"s3", "r2", "gcs", "aws"}) {
-					auto res = context->db->GetSecretManager().LookupSecret(transaction, path, type);
-					if (res.HasMatch()) {
-						refreshed_secret |= CreateS3SecretFunctions::TryRefreshS3Secret(*context, *res.secret_entry);
-					}
-				}
+				refreshed_secret = TryRefreshS3Secrets(*context, path);
 			}
 		}
 		if (!refreshed_secret) {
@@ -858,6 +1225,7 @@ void S3FileHandle::Initialize(optional_ptr<FileOpener> opener) {
 		}
 		// We have succesfully refreshed a secret: retry initializing with new credentials
 		FileOpenerInfo info = {path};
+		S3AuthParams::InvalidateCache(opener);
 		auth_params = S3AuthParams::ReadFrom(opener, info);
 		HTTPFileHandle::Initialize(opener);
 	}
@@ -932,13 +1300,11 @@ void S3FileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx
 	}
 	int64_t bytes_written = 0;
 
+	// Writes may come from multiple threads and at any offset, as long as they do not overlap: every part is filled
+	// independently and uploaded by the thread that completes it
 	while (bytes_written < nr_bytes) {
 		auto curr_location = location + bytes_written;
 
-		if (curr_location != s3fh.file_offset) {
-			throw InternalException("Non-sequential write not supported!");
-		}
-
 		// Find buffer for writing
 		auto write_buffer_idx = curr_location / s3fh.part_size;
 
@@ -949,17 +1315,26 @@ void S3FileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx
 		auto idx_to_write = curr_location - write_buffer->buffer_start;
 		auto bytes_to_write = MinValue<idx_t>(nr_bytes - bytes_written, s3fh.part_size - idx_to_write);
 		memcpy((char *)write_buffer->Ptr() + idx_to_write, (char *)buffer + bytes_written, bytes_to_write);
-		write_buffer->idx += bytes_to_write;
+		auto write_end = idx_to_write + bytes_to_write;
+		auto part_end = write_buffer->idx.load();
+		while (part_end < write_end && !write_buffer->idx.compare_exchange_weak(part_end, write_end)) {
+		}
 
-		// Flush to HTTP if full
-		if (write_buffer->idx >= s3fh.part_size) {
+		// Flush to HTTP once every byte of the part has been written
+		auto part_bytes_written = write_buffer->bytes_written.fetch_add(bytes_to_write) + bytes_to_write;
+		if (part_bytes_written >= s3fh.part_size) {
 			FlushBuffer(s3fh, write_buffer);
 		}
-		s3fh.file_offset += bytes_to_write;
 		bytes_written += bytes_to_write;
 	}
+	{
+		// The handle's offset is the end of the furthest write, so that sequential writes append to the file even after
+		// writes at earlier offsets
+		lock_guard<mutex> lck(s3fh.mu);
+		s3fh.file_offset = MaxValue<idx_t>(s3fh.file_offset, location + bytes_written);
+	}
 
-	DUCKDB_LOG_FILE_SYSTEM_WRITE(handle, bytes_written, s3fh.file_offset - bytes_written);
+	DUCKDB_LOG_FILE_SYSTEM_WRITE(handle, bytes_written, location);
 }
 
 static bool Match(vector<string>::const_iterator key, vector<string>::const_iterator key_end,
@@ -1067,6 +1442,23 @@ vector<OpenFileInfo> S3FileSystem::Glob(const string &glob_pattern, FileOpener *
 			result.push_back(std::move(s3_key));
 		}
 	}
+
+	auto &httpfs_params = http_params->Cast<HTTPFSParams>();
+	if (httpfs_params.prewarm_connections > 0 && result.size() > 1) {
+		// All results live in the same bucket: open the connections the file handles will need up-front
+		auto parsed_file_url = S3UrlParse(result[0].path, s3_auth_params);
+		HTTPHeaders headers;
+		if (IsGCSRequest(glob_pattern) && !s3_auth_params.oauth2_bearer_token.empty()) {
+			headers["Authorization"] = "Bearer " + s3_auth_params.oauth2_bearer_token;
+			headers["Host"] = parsed_file_url.host;
+		} else {
+			headers = create_s3_header(parsed_file_url.path, "", parsed_file_url.host, "s3", "HEAD", s3_auth_params, "",
+			                           "", "", "");
+		}
+		auto prewarm_count = MinValue<idx_t>(httpfs_params.prewarm_connections, result.size());
+		HTTPFSUtil::PrewarmConnections(httpfs_params, parsed_file_url.GetHTTPUrl(s3_auth_params), headers,
+		                               prewarm_count);
+	}
 	return result;
 }
 
@@ -1144,17 +1536,17 @@ HTTPException S3FileSystem::GetS3Error(S3AuthParams &s3_auth_params, const HTTPR
 }
 
 HTTPException S3FileSystem::GetHTTPError(FileHandle &handle, const HTTPResponse &response, const string &url) {
-	auto &s3_handle = handle.Cast<S3FileHandle>();
+	auto auth_params = handle.Cast<S3FileHandle>().GetAuthParams();
 	
 	// Use GCS-specific error for GCS URLs
 	if (IsGCSRequest(url) && response.status == HTTPStatusCode::Forbidden_403) {
-		string extra_text = GetGCSAuthError(s3_handle.auth_params);
+		string extra_text = GetGCSAuthError(auth_params);
 		auto status_message = HTTPFSUtil::GetStatusMessage(response.status);
 		throw HTTPException(response, "HTTP error on '%s' (HTTP %d %s)%s", url,
 		                    response.status, status_message, extra_text);
 	}
 	
-	return GetS3Error(s3_handle.auth_params, response, url);
+	return GetS3Error(auth_params, response, url);
 }
 string AWSListObjectV2::Request(string &path, HTTPParams &http_params, S3AuthParams &s3_auth_params,
                                 string &continuation_token, optional_ptr<HTTPState> state, bool use_delimiter) {